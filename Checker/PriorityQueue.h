@@ -10,6 +10,7 @@
 
 #include <algorithm>
 #include <functional>
+#include <limits>
 #include <vector>
 #include <set>
 #include <map>
@@ -270,9 +271,15 @@ public:
         }
 
     protected:
+        static Priority floorLog2(Priority n) {
+            Priority l = 0;
+            for (; n > 1; n >>= 1) { ++l; }
+            return l;
+        }
+
         static Priority getGroupIndex(Priority n) {
             #if SZX_CPPUTILIBS_PRIORITY_QUEUE_BUCKET_IMP_LOG2_GROUP_MODE
-            return ((n / GroupSizeBase == 0) ? 0 : Math::log2(n / GroupSizeBase));
+            return ((n / GroupSizeBase == 0) ? 0 : floorLog2(n / GroupSizeBase));
             #else
             return (n / GroupSize);
             #endif // SZX_CPPUTILIBS_PRIORITY_QUEUE_BUCKET_IMP_LOG2_GROUP_MODE
@@ -282,7 +289,7 @@ public:
         Priority updateFirstNonEmptyIndex(Priority pos) {
             numbersOfNonEmptyBucket[firstNonEmptyGroupIndex]--;
             if (numbersOfNonEmptyBucket[firstNonEmptyGroupIndex] == 0) {
-                if (firstNonEmptyGroupIndex == lastNonEmptyGroupIndex) { return InvalidBucketQueue; }
+                if (firstNonEmptyGroupIndex == lastNonEmptyGroupIndex) { return InvalidIndex; }
                 firstNonEmptyBucketIndices[firstNonEmptyGroupIndex] = InvalidIndex;
                 while ((numbersOfNonEmptyBucket[++firstNonEmptyGroupIndex] == 0)
                     && (firstNonEmptyGroupIndex <= lastNonEmptyGroupIndex));
@@ -12,6 +12,10 @@ int main() {
     //sim.debug();
     sim.benchmark(1);
     //sim.parallelBenchmark(1);
+    //sim.outOfCoreBenchmark({ 5000, 10000, 20000, 50000 }, 50);
+    //sim.allocatorBenchmark(4000);
+    //sim.checkFriedmanRace();
+    //sim.tuneParameters(16, 20, 10);
     //sim.generateInstance();
     //for (int i = 1; i <= 40; ++i) { sim.convertPmedInstance("Instance/pmed/pmed", i); }
     //for (int p = 10; p <= 150; p += 10) { sim.convertTspInstance("u1060", p); }
@@ -6,7 +6,10 @@
 #include <vector>
 #include <algorithm>
 #include <random>
+#include <numeric>
+#include <limits>
 
+#include <cmath>
 #include <cstring>
 
 #include "Simulator.h"
@@ -177,6 +180,21 @@ void Simulator::run(const Task &task) {
         strcpy(argv[argc++], task.logPath.c_str());
     }
 
+    if (!task.cacheDir.empty()) {
+        strcpy(argv[argc++], Cmd::CacheDirOption().c_str());
+        strcpy(argv[argc++], task.cacheDir.c_str());
+    }
+
+    if (!task.oocDir.empty()) {
+        strcpy(argv[argc++], Cmd::OutOfCoreDirOption().c_str());
+        strcpy(argv[argc++], task.oocDir.c_str());
+    }
+
+    if (!task.shareGraph.empty()) {
+        strcpy(argv[argc++], Cmd::ShareGraphOption().c_str());
+        strcpy(argv[argc++], task.shareGraph.c_str());
+    }
+
     Cmd::run(argc, argv);
 }
 
@@ -220,6 +238,7 @@ void Simulator::benchmark(int repeat) {
     task.jobNum = "1";
     task.cfgPath = Env::DefaultCfgPath();
     task.logPath = Env::DefaultLogPath();
+    task.cacheDir = Env::DefaultCacheDir();
 
     random_device rd;
     mt19937 rgen(rd());
@@ -244,6 +263,8 @@ void Simulator::parallelBenchmark(int repeat) {
     task.jobNum = "1";
     task.cfgPath = Env::DefaultCfgPath();
     task.logPath = Env::DefaultLogPath();
+    task.cacheDir = Env::DefaultCacheDir();
+    task.shareGraph = Env::ShareInProcess(); // the concurrent tasks on the same instance build G once.
 
     ThreadPool<> tp(4);
 
@@ -261,12 +282,216 @@ void Simulator::parallelBenchmark(int repeat) {
     }
 }
 
+void Simulator::outOfCoreBenchmark(const List<int> &nodeNums, int centerNum) {
+    Task task;
+    task.instSet = "";
+    task.timeout = "600";
+    task.jobNum = "1";
+    task.cfgPath = Env::DefaultCfgPath();
+    task.logPath = Env::DefaultLogPath();
+    task.oocDir = Env::DefaultOutOfCoreDir();
+
+    // the iterations and duration of each run in the log tell the throughput.
+    for (auto n = nodeNums.begin(); n != nodeNums.end(); ++n) {
+        InstanceTrait trait;
+        trait.nodeNum = Interval<int>(*n, *n);
+        trait.centerNum = Interval<int>(centerNum, centerNum);
+        generateInstance(trait);
+
+        task.instId = "rand.n" + to_string(*n) + "p" + to_string(centerNum);
+        task.randSeed = to_string(Random::generateSeed());
+        task.runId = to_string(*n);
+        run(task);
+    }
+}
+
+template<typename AllocPolicy>
+static void scanMatrix(const String &policyName, int nodeNum, int centerNum, int scanNum) {
+    Random rand(0);
+    Arr2D<Length, int, AllocPolicy> mat(nodeNum, nodeNum);
+    for (int i = 0; i < nodeNum; ++i) {
+        for (int j = 0; j < nodeNum; ++j) { mat.at(i, j) = rand.pick(Problem::MaxDistance); }
+    }
+    List<int> centers(centerNum);
+    for (auto c = centers.begin(); c != centers.end(); ++c) { *c = rand.pick(nodeNum); }
+
+    PerfCounter tlbMiss(PerfCounter::Event::DataTlbMiss);
+    PerfCounter cacheMiss(PerfCounter::Event::CacheMiss);
+    Timer timer(1s);
+    tlbMiss.start();
+    cacheMiss.start();
+    Length checksum = 0;
+    for (int s = 0; s < scanNum; ++s) {
+        // scan the row of a candidate like addFacility() and removeFacility().
+        const Length *row = mat[rand.pick(nodeNum)];
+        for (int v = 0; v < nodeNum; ++v) { checksum ^= row[v]; }
+        // read the column of a node in the rows of all centers like findNext().
+        int v = rand.pick(nodeNum);
+        for (auto c = centers.begin(); c != centers.end(); ++c) { checksum ^= mat.at(*c, v); }
+    }
+    cacheMiss.stop();
+    tlbMiss.stop();
+
+    cout << policyName << " n=" << nodeNum << " dTLB-miss=" << tlbMiss.count() << " cache-miss=" << cacheMiss.count()
+        << " seconds=" << timer.elapsedSeconds() << " checksum=" << checksum << endl;
+}
+
+void Simulator::allocatorBenchmark(int nodeNum, int centerNum, int scanNum) {
+    // a miss count of PerfCounter::Unavailable means the events are not permitted on the platform.
+    scanMatrix<PlainAlloc>("plain", nodeNum, centerNum, scanNum);
+    scanMatrix<AlignedAlloc>("aligned+thp", nodeNum, centerNum, scanNum);
+    scanMatrix<PaddedAlloc>("padded+thp", nodeNum, centerNum, scanNum);
+    scanMatrix<HugePageAlloc>("hugetlb", nodeNum, centerNum, scanNum);
+}
+
+// the 0.95 quantile of the chi-square distribution by the Wilson-Hilferty approximation.
+static double chiSquareQuantile95(int degreeOfFreedom) {
+    static constexpr double Z = 1.6449;
+    double v = 2.0 / (9.0 * degreeOfFreedom);
+    return degreeOfFreedom * pow(1 - v + Z * sqrt(v), 3);
+}
+
+// the 0.975 quantile of the student t distribution by the Cornish-Fisher expansion.
+static double tQuantile975(int degreeOfFreedom) {
+    static constexpr double Z = 1.96;
+    double z3 = Z * Z * Z;
+    double z5 = z3 * Z * Z;
+    double df = degreeOfFreedom;
+    return Z + (z3 + Z) / (4 * df) + (5 * z5 + 16 * z3 + 3 * Z) / (96 * df * df);
+}
+
+// rank the survivors on each instance and drop the ones whose rank sums are significantly worse than
+// the best one by the Friedman test and its post-hoc comparison (Conover). rankSums[i] is of survivors[i].
+static List<int> raceByFriedmanTest(const List<List<Length>> &costs, const List<int> &survivors, List<double> &rankSums) {
+    int k = static_cast<int>(survivors.size());
+    int n = static_cast<int>(costs[survivors.front()].size());
+    rankSums.assign(k, 0);
+    double squareRankSum = 0;
+    List<int> order(k);
+    for (int b = 0; b < n; ++b) {
+        auto cost = [&](int i) { return costs[survivors[order[i]]][b]; };
+        iota(order.begin(), order.end(), 0);
+        sort(order.begin(), order.end(), [&](int l, int r) { return costs[survivors[l]][b] < costs[survivors[r]][b]; });
+        for (int i = 0; i < k;) { // the tied candidates share the average rank.
+            int j = i + 1;
+            while ((j < k) && (cost(j) == cost(i))) { ++j; }
+            double rank = (i + 1 + j) / 2.0;
+            for (; i < j; ++i) {
+                rankSums[order[i]] += rank;
+                squareRankSum += rank * rank;
+            }
+        }
+    }
+
+    double c = n * k * (k + 1.0) * (k + 1.0) / 4;
+    double rankSumSquareSum = 0;
+    for (auto r = rankSums.begin(); r != rankSums.end(); ++r) { rankSumSquareSum += (*r) * (*r); }
+    if ((k < 2) || (n < 2) || (squareRankSum <= c)) { return survivors; } // all candidates tie on every instance.
+    double t = (k - 1) * (rankSumSquareSum - n * c) / (squareRankSum - c);
+    if (t <= chiSquareQuantile95(k - 1)) { return survivors; }
+
+    double bestRankSum = *min_element(rankSums.begin(), rankSums.end());
+    double variance = 2 * n * (1 - t / (n * (k - 1))) * (squareRankSum - c) / ((n - 1) * (k - 1));
+    double threshold = tQuantile975((n - 1) * (k - 1)) * sqrt(max(variance, 0.0));
+    List<int> winners;
+    for (int i = 0; i < k; ++i) {
+        if (rankSums[i] - bestRankSum <= threshold) { winners.push_back(survivors[i]); }
+    }
+    return winners;
+}
+
+bool Simulator::checkFriedmanRace() {
+    // 8 instances (rows) by 3 candidates (columns) with ranks as costs, computed by hand:
+    // rank sums R = (10, 15, 23), sum of squared ranks A = 112, C = n * k * (k + 1)^2 / 4 = 96,
+    // T = (k - 1) * (sum(R^2) - n * C) / (A - C) = 2 * (854 - 768) / 16 = 10.75 > chi2(0.95, 2) = 5.99,
+    // threshold = t(0.975, 14) * sqrt(2 * n * (1 - T / (n * (k - 1))) * (A - C) / ((n - 1) * (k - 1)))
+    //           = 2.145 * sqrt(2 * 8 * (1 - 10.75 / 16) * 16 / 14) = 2.145 * sqrt(6) = 5.25,
+    // so the second candidate (15 - 10 = 5) survives and the third one (23 - 10 = 13) is dropped.
+    List<List<Length>> ranks({ { 1, 2, 3 }, { 1, 2, 3 }, { 1, 2, 3 }, { 1, 2, 3 }, { 1, 2, 3 }, { 2, 1, 3 }, { 2, 1, 3 }, { 1, 3, 2 } });
+    List<List<Length>> costs(3);
+    for (auto r = ranks.begin(); r != ranks.end(); ++r) {
+        for (size_t c = 0; c < costs.size(); ++c) { costs[c].push_back((*r)[c]); }
+    }
+    List<double> rankSums;
+    List<int> survivors(raceByFriedmanTest(costs, { 0, 1, 2 }, rankSums));
+    bool isCorrect = (rankSums == List<double>({ 10, 15, 23 })) && (survivors == List<int>({ 0, 1 }));
+    cout << "friedman race " << (isCorrect ? "passes" : "fails") << " the hand-computed example." << endl;
+    return isCorrect;
+}
+
+void Simulator::tuneParameters(int candidateNum, int trainingNum, double secondsPerRun, const String &cfgPath) {
+    static constexpr int MinInstanceNumToTest = 3; // collect a few results before eliminating any candidate.
+    static constexpr int SampleStepNum = 100;
+    static const Interval<double> TenureNodeCoefRange(0.5, 4);
+    static const Interval<double> TenureCenterCoefRange(0.25, 4);
+
+    Random rand;
+    auto sample = [&](const Interval<double> &range) {
+        return range.begin + (range.end - range.begin) * rand.pick(SampleStepNum + 1) / SampleStepNum;
+    };
+    List<Solver::Configuration> candidates(max(candidateNum, 1)); // the first one keeps the default values.
+    for (auto c = candidates.begin() + 1; c != candidates.end(); ++c) {
+        c->tenureNodeCoef = sample(TenureNodeCoefRange);
+        c->tenureCenterCoef = sample(TenureCenterCoefRange);
+    }
+
+    List<String> trainingSet(instList);
+    shuffle(trainingSet.begin(), trainingSet.end(), mt19937(rand.pick(numeric_limits<int>::max())));
+    trainingSet.resize(min(static_cast<size_t>(max(trainingNum, 1)), trainingSet.size()));
+
+    List<List<Length>> costs(candidates.size());
+    List<int> survivors(candidates.size());
+    iota(survivors.begin(), survivors.end(), 0);
+    List<double> rankSums;
+    for (auto inst = trainingSet.begin(); (inst != trainingSet.end()) && (survivors.size() > 1); ++inst) {
+        Problem::Input input;
+        if (!input.load(InstanceDir() + *inst + ".json")) { continue; }
+        int seed = Random::generateSeed(); // the candidates meet the same randomness on each instance.
+        for (auto s = survivors.begin(); s != survivors.end(); ++s) { costs[*s].push_back(0); }
+        {
+            ThreadPool<> tp(System::availableCpuNum());
+            for (auto s = survivors.begin(); s != survivors.end(); ++s) {
+                int c = *s;
+                tp.push([&, c]() {
+                    Env env(InstanceDir() + *inst + ".json", "", seed, secondsPerRun, Env::DefaultMaxIter, 1);
+                    env.streamSolution = false;
+                    Solver solver(input, env, candidates[c]);
+                    solver.solve();
+                    costs[c].back() = solver.output.coverRadius;
+                });
+            }
+        } // wait for all runs on the instance.
+
+        if (costs[survivors.front()].size() < MinInstanceNumToTest) { continue; }
+        survivors = raceByFriedmanTest(costs, survivors, rankSums);
+        cout << *inst << " survivors=" << survivors.size() << endl;
+    }
+
+    raceByFriedmanTest(costs, survivors, rankSums);
+    int best = survivors[min_element(rankSums.begin(), rankSums.end()) - rankSums.begin()];
+    candidates[best].save(cfgPath);
+    cout << "best " << candidates[best].toBriefStr() << " saved to " << cfgPath << endl;
+}
+
 void Simulator::generateInstance(const InstanceTrait &trait) {
+    static constexpr double MaxCoord = 10000;
+
     Random rand;
 
     Problem::Input input;
 
-    // EXTEND[szx][5]: generate random instances.
+    // EXTEND[szx][5]: generate random topological instances.
+    auto pickIn = [&](const Interval<int> &range) {
+        return range.isValid() ? rand.pick(range.begin, range.end) : range.begin;
+    };
+    input.set_centernum(pickIn(trait.centerNum));
+    auto &graph(*input.mutable_graph());
+    graph.set_nodenum(pickIn(trait.nodeNum));
+    for (int n = 0; n < graph.nodenum(); ++n) { // uniformly distributed points in a square.
+        auto &node(*graph.add_nodes());
+        node.set_x(MaxCoord * rand() / Random::Generator::max());
+        node.set_y(MaxCoord * rand() / Random::Generator::max());
+    }
 
     ostringstream path;
     path << InstanceDir() << "rand.n" << input.graph().nodenum()
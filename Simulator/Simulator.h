@@ -35,6 +35,9 @@ public:
         String jobNum;
         String cfgPath;
         String logPath;
+        String cacheDir;
+        String oocDir;
+        String shareGraph;
         String runId;
     };
 
@@ -73,6 +76,17 @@ public:
     void benchmark(int repeat = 1);
     // utility for testing all instances using a thread pool.
     void parallelBenchmark(int repeat);
+    // utility for measuring the throughput of out-of-core matrices on random instances of different sizes.
+    void outOfCoreBenchmark(const List<int> &nodeNums, int centerNum);
+    // utility for measuring the tlb and cache misses of the access pattern of the solver on n*n matrices
+    // allocated by different policies.
+    void allocatorBenchmark(int nodeNum = 4000, int centerNum = 50, int scanNum = 20000);
+    // race randomly sampled tabu tenure coefficients on a random subset of the instances (F-Race)
+    // and save the best surviving configuration to cfgPath.
+    void tuneParameters(int candidateNum = 16, int trainingNum = 20, double secondsPerRun = 10,
+        const String &cfgPath = Env::DefaultCfgPath());
+    // check the elimination of tuneParameters() against a hand-computed example.
+    bool checkFriedmanRace();
 
 
     void generateInstance(const InstanceTrait &trait);
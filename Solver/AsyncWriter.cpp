@@ -0,0 +1,60 @@
+#include "AsyncWriter.h"
+
+#include <cstdio>
+
+
+using namespace std;
+
+
+namespace szx {
+
+AsyncWriter::~AsyncWriter() {
+    {
+        lock_guard<mutex> guard(mtx);
+        isStopped = true;
+    }
+    workCond.notify_one();
+    worker.join(); // the pending writes are done before the thread exits.
+}
+
+void AsyncWriter::post(const String &path, Writer write) {
+    {
+        lock_guard<mutex> guard(mtx);
+        pending[path] = move(write);
+    }
+    workCond.notify_one();
+}
+
+void AsyncWriter::flush() {
+    unique_lock<mutex> lock(mtx);
+    idleCond.wait(lock, [this]() { return pending.empty() && !isBusy; });
+}
+
+void AsyncWriter::loop() {
+    unique_lock<mutex> lock(mtx);
+    for (;;) {
+        workCond.wait(lock, [this]() { return isStopped || !pending.empty(); });
+        if (pending.empty()) { break; } // stopped.
+
+        String path(pending.begin()->first);
+        Writer write(move(pending.begin()->second));
+        pending.erase(pending.begin());
+        isBusy = true;
+        lock.unlock();
+
+        String tmpPath(path + ".tmp");
+        if (!write(tmpPath)) {
+            remove(tmpPath.c_str());
+        } else if (rename(tmpPath.c_str(), path.c_str()) != 0) { // it fails on Windows if the target exists.
+            remove(path.c_str());
+            if (rename(tmpPath.c_str(), path.c_str()) != 0) { remove(tmpPath.c_str()); }
+        }
+
+        lock.lock();
+        isBusy = false;
+        if (pending.empty()) { idleCond.notify_all(); }
+    }
+    idleCond.notify_all();
+}
+
+}
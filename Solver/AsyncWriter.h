@@ -0,0 +1,60 @@
+////////////////////////////////
+/// usage : 1.	write files in a background thread so that the search never waits for the disk.
+///
+/// note  : 1.	only the latest pending write to each path is kept, so frequent improvements
+///             are coalesced into a few writes.
+///         2.	each file is written to a temporary file first and renamed, so readers and
+///             killed processes never leave a partially written file behind.
+////////////////////////////////
+
+#ifndef SMART_SZX_P_CENTER_ASYNC_WRITER_H
+#define SMART_SZX_P_CENTER_ASYNC_WRITER_H
+
+
+#include "Config.h"
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "Common.h"
+
+
+namespace szx {
+
+class AsyncWriter {
+public:
+    // write the content to the given (temporary) path. return false on failure.
+    using Writer = std::function<bool(const String &path)>;
+
+
+    AsyncWriter() : isStopped(false), isBusy(false), worker([this]() { loop(); }) {}
+    AsyncWriter(const AsyncWriter &) = delete;
+    AsyncWriter& operator=(const AsyncWriter &) = delete;
+    ~AsyncWriter();
+
+
+    // replace the pending write to the path if there is one.
+    void post(const String &path, Writer write);
+    // wait until all posted writes are done.
+    void flush();
+
+protected:
+    void loop();
+
+
+    std::mutex mtx;
+    std::condition_variable workCond;
+    std::condition_variable idleCond;
+    Map<String, Writer> pending;
+    bool isStopped;
+    bool isBusy;
+
+    std::thread worker; // start it after the other fields are ready.
+};
+
+}
+
+
+#endif // SMART_SZX_P_CENTER_ASYNC_WRITER_H
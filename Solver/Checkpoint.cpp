@@ -0,0 +1,77 @@
+#include "Checkpoint.h"
+
+#include <fstream>
+
+
+using namespace std;
+
+
+namespace szx {
+
+template<typename T>
+static void writeValue(ofstream &ofs, const T &value) {
+    ofs.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+static void writeList(ofstream &ofs, const List<T> &list) {
+    writeValue(ofs, static_cast<uint64_t>(list.size()));
+    ofs.write(reinterpret_cast<const char*>(list.data()), sizeof(T) * list.size());
+}
+
+template<typename T>
+static bool readValue(ifstream &ifs, T &value) {
+    return static_cast<bool>(ifs.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+template<typename T>
+static bool readList(ifstream &ifs, List<T> &list, uint64_t maxSize) {
+    uint64_t size = 0;
+    if (!readValue(ifs, size) || (size > maxSize)) { return false; }
+    list.resize(static_cast<size_t>(size));
+    return static_cast<bool>(ifs.read(reinterpret_cast<char*>(list.data()), sizeof(T) * list.size()));
+}
+
+
+bool Checkpoint::save(const String &path) const {
+    ofstream ofs(path, ios::binary);
+    if (!ofs.is_open()) { return false; }
+
+    writeValue(ofs, Magic);
+    writeValue(ofs, Version);
+    writeValue(ofs, graphHash);
+    writeValue(ofs, nodeNum);
+    writeValue(ofs, centerNum);
+    writeValue(ofs, iteration);
+    writeValue(ofs, tabuTenure);
+    writeValue(ofs, bestRadius);
+    writeList(ofs, List<char>(rngState.begin(), rngState.end()));
+    writeList(ofs, centers);
+    writeList(ofs, bestCenters);
+    writeList(ofs, tabu);
+    ofs.close();
+    return static_cast<bool>(ofs);
+}
+
+bool Checkpoint::load(const String &path) {
+    ifstream ifs(path, ios::binary);
+    if (!ifs.is_open()) { return false; }
+
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    if (!readValue(ifs, magic) || !readValue(ifs, version) || (magic != Magic) || (version != Version)) { return false; }
+    if (!readValue(ifs, graphHash) || !readValue(ifs, nodeNum) || !readValue(ifs, centerNum)
+        || !readValue(ifs, iteration) || !readValue(ifs, tabuTenure) || !readValue(ifs, bestRadius)) {
+        return false;
+    }
+    uint64_t nodeNumber = (nodeNum > 0) ? nodeNum : 0;
+    List<char> rng;
+    if (!readList(ifs, rng, 1 << 16) || !readList(ifs, centers, nodeNumber)
+        || !readList(ifs, bestCenters, nodeNumber) || !readList(ifs, tabu, nodeNumber * nodeNumber)) {
+        return false;
+    }
+    rngState.assign(rng.begin(), rng.end());
+    return true;
+}
+
+}
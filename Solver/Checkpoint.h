@@ -0,0 +1,57 @@
+////////////////////////////////
+/// usage : 1.	snapshot of the tabu search to resume an interrupted run.
+///
+/// note  : 1.	the node ids are the internal ones after renumbering, so a checkpoint is only
+///             valid for the same graph hash (which changes with the renumbering).
+///         2.	the distances to the centers are recomputed from the centers on resume.
+////////////////////////////////
+
+#ifndef SMART_SZX_P_CENTER_CHECKPOINT_H
+#define SMART_SZX_P_CENTER_CHECKPOINT_H
+
+
+#include "Config.h"
+
+#include <cstdint>
+
+#include "Common.h"
+#include "DistanceCache.h"
+
+
+namespace szx {
+
+struct Checkpoint {
+    static constexpr std::uint32_t Magic = 0x4b435a53; // "SZCK".
+    static constexpr std::uint32_t Version = 1;
+
+
+    struct TabuMove {
+        ID c;
+        ID f;
+        int until; // the iteration until which swapping c and f is forbidden.
+    };
+
+
+    bool save(const String &path) const;
+    // return false if the file is missing or broken.
+    bool load(const String &path);
+
+
+    DistanceCache::Hash graphHash = 0;
+    ID nodeNum = 0;
+    ID centerNum = 0;
+
+    int iteration = 0;
+    Length tabuTenure = 0;
+    Length bestRadius = 0;
+    String rngState; // the text form of Random::Generator.
+
+    List<ID> centers;
+    List<ID> bestCenters;
+    List<TabuMove> tabu; // the unexpired moves only.
+};
+
+}
+
+
+#endif // SMART_SZX_P_CENTER_CHECKPOINT_H
@@ -73,6 +73,12 @@
 #else
 #define _CC_CLANG  0
 #endif // __clang__
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__) // the avx2 code is picked at runtime.
+#define _INS_X86  1
+#else
+#define _INS_X86  0
+#endif // _M_X64
 #pragma endregion PlatformCheck
 
 #pragma region LinkLibraryCheck
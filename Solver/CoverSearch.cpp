@@ -0,0 +1,123 @@
+#include "CoverSearch.h"
+
+
+using namespace std;
+
+
+namespace szx {
+
+bool CoverSearch::solve(const LargeArr2D<Length> &sortedGraph, const List<ID> &coverNumbers, List<ID> &solution,
+    int maxStagnation, Random &rand, const Terminator &isTimeOut) {
+    sortedG = &sortedGraph;
+    coverNum = &coverNumbers;
+    reset(sortedGraph.size1(), solution);
+
+    size_t bestUncoveredNum = uncovered.size();
+    for (long long lastImprovement = stepNum; !uncovered.empty(); ++stepNum) {
+        if ((stepNum - lastImprovement > maxStagnation) || isTimeOut()) { return false; }
+
+        // add the best allowed node covering a random uncovered node.
+        ID v = uncovered[rand.pick(static_cast<int>(uncovered.size()))];
+        ID u = -1;
+        for (auto n = neighborBegin(v); n != neighborEnd(v); ++n) {
+            if (!isChecked[*n]) { continue; }
+            if ((u < 0) || (gain[*n] > gain[u]) || ((gain[*n] == gain[u]) && (lastMove[*n] < lastMove[u]))) { u = *n; }
+        }
+        if (u < 0) { u = *(neighborBegin(v) + rand.pick(static_cast<int>(neighborEnd(v) - neighborBegin(v)))); }
+        addCenter(u);
+
+        // remove the center uncovering the least weight except the new one.
+        ID c = -1;
+        for (auto f = centers.begin(); f != centers.end(); ++f) {
+            if (*f == u) { continue; }
+            if ((c < 0) || (loss[*f] < loss[c]) || ((loss[*f] == loss[c]) && (lastMove[*f] < lastMove[c]))) { c = *f; }
+        }
+        removeCenter(c);
+        isChecked[c] = false;
+        lastMove[u] = lastMove[c] = stepNum;
+
+        for (auto w = uncovered.begin(); w != uncovered.end(); ++w) {
+            ++weight[*w];
+            for (auto n = neighborBegin(*w); n != neighborEnd(*w); ++n) { ++gain[*n]; }
+        }
+        if (uncovered.size() < bestUncoveredNum) {
+            bestUncoveredNum = uncovered.size();
+            lastImprovement = stepNum;
+        }
+    }
+    solution = centers;
+    return true;
+}
+
+void CoverSearch::reset(ID nodeNum, const List<ID> &initCenters) {
+    centers.clear();
+    centerIndex.assign(nodeNum, -1);
+    uncovered.resize(nodeNum);
+    uncoveredIndex.resize(nodeNum);
+    for (ID v = 0; v < nodeNum; ++v) { uncovered[v] = uncoveredIndex[v] = v; }
+    coverCount.assign(nodeNum, 0);
+    coverSum.assign(nodeNum, 0);
+    weight.assign(nodeNum, 1);
+    gain.resize(nodeNum);
+    for (ID v = 0; v < nodeNum; ++v) { gain[v] = (*coverNum)[v]; }
+    loss.assign(nodeNum, 0);
+    isChecked.assign(nodeNum, true);
+    lastMove.assign(nodeNum, 0);
+    stepNum = 0;
+
+    for (auto c = initCenters.begin(); c != initCenters.end(); ++c) {
+        if (centerIndex[*c] < 0) { addCenter(*c); }
+    }
+}
+
+void CoverSearch::addCenter(ID u) {
+    centerIndex[u] = static_cast<ID>(centers.size());
+    centers.push_back(u);
+    for (auto v = neighborBegin(u); v != neighborEnd(u); ++v) {
+        ++coverCount[*v];
+        coverSum[*v] += u;
+        if (coverCount[*v] == 1) {
+            cover(*v);
+            loss[u] += weight[*v];
+        } else if (coverCount[*v] == 2) { // the other center no longer covers it alone.
+            loss[coverSum[*v] - u] -= weight[*v];
+        }
+        isChecked[*v] = true;
+    }
+}
+
+void CoverSearch::removeCenter(ID c) {
+    ID index = centerIndex[c];
+    centers[index] = centers.back();
+    centerIndex[centers[index]] = index;
+    centers.pop_back();
+    centerIndex[c] = -1;
+    for (auto v = neighborBegin(c); v != neighborEnd(c); ++v) {
+        --coverCount[*v];
+        coverSum[*v] -= c;
+        if (coverCount[*v] == 0) {
+            uncover(*v);
+            loss[c] -= weight[*v];
+        } else if (coverCount[*v] == 1) {
+            loss[coverSum[*v]] += weight[*v];
+        }
+        isChecked[*v] = true;
+    }
+}
+
+void CoverSearch::cover(ID v) {
+    ID index = uncoveredIndex[v];
+    uncovered[index] = uncovered.back();
+    uncoveredIndex[uncovered[index]] = index;
+    uncovered.pop_back();
+    uncoveredIndex[v] = -1;
+    for (auto n = neighborBegin(v); n != neighborEnd(v); ++n) { gain[*n] -= weight[v]; }
+}
+
+void CoverSearch::uncover(ID v) {
+    uncoveredIndex[v] = static_cast<ID>(uncovered.size());
+    uncovered.push_back(v);
+    for (auto n = neighborBegin(v); n != neighborEnd(v); ++n) { gain[*n] += weight[v]; }
+}
+
+}
@@ -0,0 +1,74 @@
+////////////////////////////////
+/// usage : 1.	local search for p centers covering all nodes within a fixed radius, which is the
+///             decision version of the p-center problem (a weighted set cover).
+///
+/// note  : 1.	the nodes within the radius of v are the prefix sortedG[v][0, coverNum[v]). the
+///             distances are symmetric, so they are both the nodes covering v and covered by v.
+///         2.	each step adds a node covering a random uncovered node and removes the center whose
+///             removal uncovers the least weight, then the weights of the uncovered nodes grow so
+///             that the hard ones get covered eventually.
+///         3.	configuration checking forbids adding a removed node back until the coverage of
+///             some node near it changes, which avoids cycling.
+///         4.	the sum of the ids of the centers covering each node gives the only one in O(1).
+////////////////////////////////
+
+#ifndef SMART_SZX_P_CENTER_COVER_SEARCH_H
+#define SMART_SZX_P_CENTER_COVER_SEARCH_H
+
+
+#include "Config.h"
+
+#include <functional>
+
+#include "Common.h"
+#include "Utility.h"
+
+
+namespace szx {
+
+class CoverSearch {
+public:
+    using Terminator = std::function<bool()>;
+    using Weight = long long;
+
+
+    // improve the centers until all nodes are covered. return false if no cover is found
+    // within maxStagnation steps without covering more nodes or the time is out.
+    bool solve(const LargeArr2D<Length> &sortedG, const List<ID> &coverNum, List<ID> &centers,
+        int maxStagnation, Random &rand, const Terminator &isTimeOut);
+
+    long long getStepNum() const { return stepNum; }
+
+protected:
+    void reset(ID nodeNum, const List<ID> &centers);
+    void addCenter(ID u);
+    void removeCenter(ID c);
+    void cover(ID v);
+    void uncover(ID v);
+    // the nodes within the radius of v.
+    const Length* neighborBegin(ID v) const { return sortedG->begin(v); }
+    const Length* neighborEnd(ID v) const { return sortedG->begin(v) + (*coverNum)[v]; }
+
+
+    const LargeArr2D<Length> *sortedG = nullptr;
+    const List<ID> *coverNum = nullptr;
+
+    List<ID> centers;
+    List<ID> centerIndex; // the index of each node in centers or -1 if it is not a center.
+    List<ID> uncovered;
+    List<ID> uncoveredIndex; // the index of each node in uncovered or -1 if it is covered.
+    List<ID> coverCount; // the number of centers covering each node.
+    List<long long> coverSum; // the sum of the ids of the centers covering each node.
+    List<Weight> weight; // the weight of each node.
+    List<Weight> gain; // the weight of the uncovered nodes covered by adding each node.
+    List<Weight> loss; // the weight of the nodes only covered by each center.
+    List<bool> isChecked; // configuration checking. a node can be added if it is true.
+    List<long long> lastMove; // the step that each node was added or removed.
+
+    long long stepNum = 0;
+};
+
+}
+
+
+#endif // SMART_SZX_P_CENTER_COVER_SEARCH_H
@@ -0,0 +1,130 @@
+#include "CoverageBitset.h"
+
+#if _INS_X86
+#include <immintrin.h>
+#endif // _INS_X86
+#if _CC_MS_VC
+#include <intrin.h>
+#endif // _CC_MS_VC
+
+
+using namespace std;
+
+
+namespace szx {
+
+#if _INS_X86 && (_CC_GNU_GCC || _CC_CLANG)
+#define SZX_TARGET_AVX2  __attribute__((target("avx2")))
+#else
+#define SZX_TARGET_AVX2 // msvc emits the avx2 intrinsics without /arch:AVX2.
+#endif // _INS_X86
+
+static CoverageBitset::Word popcount(CoverageBitset::Word w) {
+    #if _CC_MS_VC && defined(_WIN64)
+    return __popcnt64(w);
+    #elif _CC_MS_VC
+    return __popcnt(static_cast<unsigned>(w)) + __popcnt(static_cast<unsigned>(w >> 32));
+    #else
+    return __builtin_popcountll(w);
+    #endif // _CC_MS_VC
+}
+
+#if _INS_X86
+// the callers must check isAvx2Supported() first and finish the trailing (wordNum % 4) words.
+SZX_TARGET_AVX2 static ID uniteAvx2(CoverageBitset::Word *dst, const CoverageBitset::Word *src, ID wordNum) {
+    ID w = 0;
+    for (; w + 4 <= wordNum; w += 4) {
+        __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + w));
+        __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + w));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + w), _mm256_or_si256(d, s));
+    }
+    return w;
+}
+
+SZX_TARGET_AVX2 static ID intersectsAvx2(const CoverageBitset::Word *l, const CoverageBitset::Word *r, ID wordNum, bool &isIntersected) {
+    ID w = 0;
+    for (; w + 4 <= wordNum; w += 4) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(l + w));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(r + w));
+        if (!_mm256_testz_si256(a, b)) { isIntersected = true; break; }
+    }
+    return w;
+}
+
+SZX_TARGET_AVX2 static ID countAvx2(const CoverageBitset::Word *bits, ID wordNum, ID &num) {
+    ID w = 0;
+    // count the bits of each nibble by table lookup and sum up the bytes (Mula).
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i lowNibble = _mm256_set1_epi8(0x0f);
+    __m256i sum = _mm256_setzero_si256();
+    for (; w + 4 <= wordNum; w += 4) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bits + w));
+        __m256i lo = _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, lowNibble));
+        __m256i hi = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), lowNibble));
+        sum = _mm256_add_epi64(sum, _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256()));
+    }
+    alignas(32) CoverageBitset::Word lanes[4]; // _mm256_extract_epi64() is absent on 32-bit targets.
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), sum);
+    num += static_cast<ID>(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+    return w;
+}
+#endif // _INS_X86
+
+bool CoverageBitset::isAvx2Supported() {
+    #if _INS_X86 && _CC_MS_VC
+    static const bool isSupported = []() {
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) { return false; }
+        __cpuid(info, 1);
+        const int OsXsave = (1 << 27);
+        const int Avx = (1 << 28);
+        if ((info[2] & (OsXsave | Avx)) != (OsXsave | Avx)) { return false; }
+        if ((_xgetbv(0) & 0x6) != 0x6) { return false; } // the os saves the ymm registers.
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+    }();
+    return isSupported;
+    #elif _INS_X86
+    static const bool isSupported = (__builtin_cpu_supports("avx2") != 0);
+    return isSupported;
+    #else
+    return false;
+    #endif // _INS_X86
+}
+
+void CoverageBitset::unite(Word *dst, const Word *src, ID wordNum) {
+    ID w = 0;
+    #if _INS_X86
+    if (isAvx2Supported()) { w = uniteAvx2(dst, src, wordNum); }
+    #endif // _INS_X86
+    for (; w < wordNum; ++w) { dst[w] |= src[w]; }
+}
+
+bool CoverageBitset::intersects(const Word *l, const Word *r, ID wordNum) {
+    ID w = 0;
+    #if _INS_X86
+    if (isAvx2Supported()) {
+        bool isIntersected = false;
+        w = intersectsAvx2(l, r, wordNum, isIntersected);
+        if (isIntersected) { return true; }
+    }
+    #endif // _INS_X86
+    for (; w < wordNum; ++w) {
+        if (l[w] & r[w]) { return true; }
+    }
+    return false;
+}
+
+ID CoverageBitset::count(const Word *bits, ID wordNum) {
+    ID num = 0;
+    ID w = 0;
+    #if _INS_X86
+    if (isAvx2Supported()) { w = countAvx2(bits, wordNum, num); }
+    #endif // _INS_X86
+    for (; w < wordNum; ++w) { num += static_cast<ID>(popcount(bits[w])); }
+    return num;
+}
+
+}
@@ -0,0 +1,81 @@
+////////////////////////////////
+/// usage : 1.	the nodes within a fixed radius of each node as packed bitsets, so the coverage of a
+///             set of centers is the union of their rows and its size is a population count.
+///
+/// note  : 1.	each row takes ceil(n / 64) words and is padded to cache lines, e.g., 10 lines for
+///             5000 nodes, while a row of G takes 313 lines.
+///         2.	the union, intersection test and population count use AVX2 if the cpu supports it,
+///             and the 64-bit scalar instructions otherwise. only their kernels in CoverageBitset.cpp
+///             are compiled for AVX2, so the binaries still run on the older x86 cpus.
+////////////////////////////////
+
+#ifndef SMART_SZX_P_CENTER_COVERAGE_BITSET_H
+#define SMART_SZX_P_CENTER_COVERAGE_BITSET_H
+
+
+#include "Config.h"
+
+#include <cstdint>
+
+#include "Common.h"
+#include "Utility.h"
+
+
+namespace szx {
+
+class CoverageBitset {
+public:
+    using Word = std::uint64_t;
+
+    static constexpr ID WordBits = 64;
+
+
+    static ID wordNumOf(ID nodeNum) { return (nodeNum + WordBits - 1) / WordBits; }
+
+
+    // bit n of row v is set if the distance between v and n is no greater than the radius.
+    // distRow(v) returns the distances from v to all nodes.
+    template<typename RowGetter>
+    void init(ID nodeNumber, Length radius, RowGetter distRow) {
+        nodeNum = nodeNumber;
+        wordNum = wordNumOf(nodeNum);
+        bits.init(nodeNum, wordNum);
+        bits.reset(); // the padding words should never be counted.
+        for (ID v = 0; v < nodeNum; ++v) {
+            const Length *dist = distRow(v);
+            Word *row = bits[v];
+            for (ID w = 0, n = 0; w < wordNum; ++w) { // accumulate each word in a register.
+                Word word = 0;
+                for (ID b = 0; (b < WordBits) && (n < nodeNum); ++b, ++n) {
+                    word |= static_cast<Word>(dist[n] <= radius) << b;
+                }
+                row[w] = word;
+            }
+        }
+    }
+
+    ID getNodeNum() const { return nodeNum; }
+    ID getWordNum() const { return wordNum; }
+
+    const Word* row(ID v) const { return bits[v]; }
+    ID coverNum(ID v) const { return count(bits[v], wordNum); }
+
+
+    // dst |= src.
+    static void unite(Word *dst, const Word *src, ID wordNum);
+    // return true if (l & r) is not empty.
+    static bool intersects(const Word *l, const Word *r, ID wordNum);
+    static ID count(const Word *bits, ID wordNum);
+
+    static bool isAvx2Supported(); // checked once by cpuid.
+
+protected:
+    ID nodeNum = 0;
+    ID wordNum = 0;
+    Arr2D<Word, ID, PaddedAlloc> bits;
+};
+
+}
+
+
+#endif // SMART_SZX_P_CENTER_COVERAGE_BITSET_H
@@ -0,0 +1,88 @@
+#include "DistanceCache.h"
+
+#include <fstream>
+#include <random>
+#include <cstdio>
+#include <cstring>
+
+
+using namespace std;
+
+
+namespace szx {
+
+DistanceCache::Hash DistanceCache::hash(const pb::PCenter::UndirectGraph &graph) {
+    static constexpr Hash OffsetBasis = 14695981039346656037ull;
+    static constexpr Hash Prime = 1099511628211ull;
+
+    Hash h = OffsetBasis;
+    auto feed = [&](const void *data, size_t size) {
+        const unsigned char *bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) { h = (h ^ bytes[i]) * Prime; }
+    };
+
+    int32_t nodeNum = graph.nodenum();
+    feed(&nodeNum, sizeof(nodeNum));
+    for (auto e = graph.edges().begin(); e != graph.edges().end(); ++e) {
+        int32_t edge[] = { e->source(), e->target(), e->length() };
+        feed(edge, sizeof(edge));
+    }
+    for (auto n = graph.nodes().begin(); n != graph.nodes().end(); ++n) {
+        double coord[] = { n->x(), n->y() };
+        feed(coord, sizeof(coord));
+    }
+    return h;
+}
+
+String DistanceCache::path(const String &cacheDir, Hash graphHash) {
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.dist", static_cast<unsigned long long>(graphHash));
+    return cacheDir + name;
+}
+
+bool DistanceCache::load(const String &cacheDir, Hash graphHash, ID nodeNum, LargeArr2D<Length> &adjMat, LargeArr2D<Length> &sortedAdjList) {
+    if (!file.open(path(cacheDir, graphHash), MappedFile::Mode::ReadOnly)) { return false; }
+
+    size_t matSize = sizeof(Length) * static_cast<size_t>(nodeNum) * nodeNum;
+    if (file.size() != (sizeof(Header) + 2 * matSize)) { file.close(); return false; }
+
+    Header header;
+    memcpy(&header, file.data(), sizeof(Header));
+    if ((header.magic != Magic) || (header.version != Version) || (header.nodeNum != nodeNum)
+        || (header.lengthSize != sizeof(Length)) || (header.graphHash != graphHash)) {
+        file.close();
+        return false;
+    }
+
+    Length *mat = reinterpret_cast<Length*>(file.data() + sizeof(Header));
+    adjMat.attach(nodeNum, nodeNum, mat);
+    sortedAdjList.attach(nodeNum, nodeNum, mat + adjMat.size());
+    return true;
+}
+
+bool DistanceCache::save(const String &cacheDir, Hash graphHash, const LargeArr2D<Length> &adjMat, const LargeArr2D<Length> &sortedAdjList) {
+    System::makeSureDirExist(cacheDir);
+
+    String finalPath(path(cacheDir, graphHash));
+    random_device rd;
+    String tmpPath(finalPath + "." + to_string(rd()) + ".tmp");
+
+    Header header = { Magic, Version, adjMat.size1(), sizeof(Length), graphHash };
+    ofstream ofs(tmpPath, ios::binary);
+    if (!ofs.is_open()) { return false; }
+    ofs.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+    ofs.write(reinterpret_cast<const char*>(adjMat.begin()), sizeof(Length) * adjMat.size());
+    ofs.write(reinterpret_cast<const char*>(sortedAdjList.begin()), sizeof(Length) * sortedAdjList.size());
+    ofs.close();
+    if (!ofs) { remove(tmpPath.c_str()); return false; }
+
+    // readers never see a partially written cache. if another solver has published
+    // the same cache in the meantime, the rename fails on some platforms which is fine.
+    if (rename(tmpPath.c_str(), finalPath.c_str()) != 0) {
+        remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,63 @@
+////////////////////////////////
+/// usage : 1.	on-disk cache of the preprocessed distance matrix and sorted neighbor lists.
+///         2.	the cache file is memory mapped read-only so that concurrent solvers share the pages.
+///
+/// note  : 1.	the cache is keyed by the content of the graph, so instances which only differ
+///             in the number of centers share the same cache file.
+////////////////////////////////
+
+#ifndef SMART_SZX_P_CENTER_DISTANCE_CACHE_H
+#define SMART_SZX_P_CENTER_DISTANCE_CACHE_H
+
+
+#include "Config.h"
+
+#include <cstdint>
+
+#include "Common.h"
+#include "Utility.h"
+#include "PCenter.pb.h"
+
+
+namespace szx {
+
+class DistanceCache {
+public:
+    using Hash = std::uint64_t;
+
+
+    static constexpr std::uint32_t Magic = 0x43435a53; // "SZCC".
+    static constexpr std::uint32_t Version = 1;
+
+
+    struct Header {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::int32_t nodeNum;
+        std::int32_t lengthSize; // sizeof(Length) when the cache is written.
+        Hash graphHash;
+    };
+
+
+    // FNV-1a over the node number, edges and node coordinates of the graph.
+    static Hash hash(const pb::PCenter::UndirectGraph &graph);
+
+    static String path(const String &cacheDir, Hash graphHash);
+
+    // map the cache file and attach adjMat and sortedAdjList to it.
+    // return false if there is no valid cache for the graph.
+    bool load(const String &cacheDir, Hash graphHash, ID nodeNum, LargeArr2D<Length> &adjMat, LargeArr2D<Length> &sortedAdjList);
+
+    bool isLoaded() const { return file.isOpen(); }
+
+    // write the matrices into a temporary file and publish it atomically.
+    static bool save(const String &cacheDir, Hash graphHash, const LargeArr2D<Length> &adjMat, const LargeArr2D<Length> &sortedAdjList);
+
+protected:
+    MappedFile file;
+};
+
+}
+
+
+#endif // SMART_SZX_P_CENTER_DISTANCE_CACHE_H
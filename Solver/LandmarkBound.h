@@ -0,0 +1,84 @@
+////////////////////////////////
+/// usage : 1.	lower bounds of the distances between any 2 nodes by the triangle inequality
+///             on the distances to a few landmarks (ALT).
+///
+/// note  : 1.	the landmarks are picked farthest first so that they lie on the periphery.
+///         2.	the distances of geometrical graphs are rounded, so the bounds are reduced by the
+///             given slack to stay admissible.
+////////////////////////////////
+
+#ifndef SMART_SZX_P_CENTER_LANDMARK_BOUND_H
+#define SMART_SZX_P_CENTER_LANDMARK_BOUND_H
+
+
+#include "Config.h"
+
+#include <algorithm>
+#include <functional>
+
+#include "Common.h"
+#include "Utility.h"
+#include "Problem.h"
+
+
+namespace szx {
+
+class LandmarkBound {
+public:
+    using RowFiller = std::function<void(ID src, Length *row)>;
+
+
+    LandmarkBound() : landmarkNum(0), slack(0) {}
+
+
+    void init(ID landmarkNumber, ID nodeNum, ID firstLandmark, Length boundSlack, const RowFiller &fill) {
+        landmarkNum = (std::min)(landmarkNumber, nodeNum);
+        slack = boundSlack;
+        landmarks.clear();
+        dist.init(nodeNum, landmarkNum);
+
+        List<Length> row(nodeNum);
+        List<Length> minDist(nodeNum, Problem::MaxDistance);
+        ID landmark = firstLandmark;
+        for (ID l = 0; l < landmarkNum; ++l) {
+            landmarks.push_back(landmark);
+            fill(landmark, row.data());
+            for (ID n = 0; n < nodeNum; ++n) {
+                dist.at(n, l) = row[n];
+                minDist[n] = (std::min)(minDist[n], row[n]);
+            }
+            // prefer reachable nodes as the next landmark.
+            landmark = 0;
+            for (ID n = 0; n < nodeNum; ++n) {
+                if ((minDist[n] < Problem::MaxDistance) && (minDist[n] > minDist[landmark])) { landmark = n; }
+            }
+        }
+    }
+
+    bool isEnabled() const { return (landmarkNum > 0); }
+
+    Length lowerBound(ID src, ID dst) const {
+        const Length *s = dist[src];
+        const Length *d = dist[dst];
+        Length lb = 0;
+        for (ID l = 0; l < landmarkNum; ++l) {
+            Length diff = (s[l] > d[l]) ? (s[l] - d[l]) : (d[l] - s[l]);
+            if (diff > lb) { lb = diff; }
+        }
+        return (lb > slack) ? (lb - slack) : 0;
+    }
+
+    const List<ID>& getLandmarks() const { return landmarks; }
+
+protected:
+    ID landmarkNum;
+    Length slack;
+
+    List<ID> landmarks;
+    Arr2D<Length> dist; // dist[n][l] is the distance between node n and the l_th landmark.
+};
+
+}
+
+
+#endif // SMART_SZX_P_CENTER_LANDMARK_BOUND_H
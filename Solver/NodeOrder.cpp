@@ -0,0 +1,115 @@
+#include "NodeOrder.h"
+
+#include <algorithm>
+#include <cstdint>
+
+
+using namespace std;
+
+
+namespace szx {
+
+List<ID> NodeOrder::hilbert(const pb::PCenter::UndirectGraph &graph) {
+    static constexpr int Level = 16; // the grid is (1 << Level) by (1 << Level).
+    static constexpr uint32_t GridSize = (1u << Level);
+
+    ID nodeNum = graph.nodes().size();
+    double minX = 0, maxX = 0, minY = 0, maxY = 0;
+    for (ID n = 0; n < nodeNum; ++n) {
+        double x = graph.nodes(n).x();
+        double y = graph.nodes(n).y();
+        if ((n == 0) || (x < minX)) { minX = x; }
+        if ((n == 0) || (x > maxX)) { maxX = x; }
+        if ((n == 0) || (y < minY)) { minY = y; }
+        if ((n == 0) || (y > maxY)) { maxY = y; }
+    }
+    double scale = (GridSize - 1) / (max)((max)(maxX - minX, maxY - minY), 1e-9);
+
+    List<pair<uint64_t, ID>> keys(nodeNum);
+    for (ID n = 0; n < nodeNum; ++n) {
+        uint32_t x = static_cast<uint32_t>((graph.nodes(n).x() - minX) * scale);
+        uint32_t y = static_cast<uint32_t>((graph.nodes(n).y() - minY) * scale);
+        uint64_t d = 0;
+        for (uint32_t s = GridSize / 2; s > 0; s /= 2) { // rotate the quadrant at each level.
+            uint32_t rx = (x & s) ? 1 : 0;
+            uint32_t ry = (y & s) ? 1 : 0;
+            d += static_cast<uint64_t>(s) * s * ((3 * rx) ^ ry);
+            if (ry == 0) {
+                if (rx == 1) {
+                    x = GridSize - 1 - x;
+                    y = GridSize - 1 - y;
+                }
+                swap(x, y);
+            }
+        }
+        keys[n] = { d, n };
+    }
+    sort(keys.begin(), keys.end());
+
+    List<ID> newIdOf(nodeNum);
+    for (ID i = 0; i < nodeNum; ++i) { newIdOf[keys[i].second] = i; }
+    return newIdOf;
+}
+
+List<ID> NodeOrder::reverseCuthillMcKee(const pb::PCenter::UndirectGraph &graph) {
+    ID nodeNum = graph.nodenum();
+    List<List<ID>> adjList(nodeNum);
+    for (auto e = graph.edges().begin(); e != graph.edges().end(); ++e) {
+        if (e->source() == e->target()) { continue; }
+        adjList[e->source()].push_back(e->target());
+        adjList[e->target()].push_back(e->source());
+    }
+    for (auto a = adjList.begin(); a != adjList.end(); ++a) {
+        sort(a->begin(), a->end());
+        a->erase(unique(a->begin(), a->end()), a->end());
+    }
+    auto lessDegree = [&](ID l, ID r) { return adjList[l].size() < adjList[r].size(); };
+
+    List<ID> roots(nodeNum);
+    for (ID n = 0; n < nodeNum; ++n) { roots[n] = n; }
+    stable_sort(roots.begin(), roots.end(), lessDegree);
+
+    // breadth first search from the node with the least degree in each component.
+    List<ID> order;
+    order.reserve(nodeNum);
+    List<bool> visited(nodeNum, false);
+    for (auto r = roots.begin(); r != roots.end(); ++r) {
+        if (visited[*r]) { continue; }
+        visited[*r] = true;
+        order.push_back(*r);
+        for (size_t head = order.size() - 1; head < order.size(); ++head) {
+            size_t begin = order.size();
+            for (auto n = adjList[order[head]].begin(); n != adjList[order[head]].end(); ++n) {
+                if (visited[*n]) { continue; }
+                visited[*n] = true;
+                order.push_back(*n);
+            }
+            stable_sort(order.begin() + begin, order.end(), lessDegree);
+        }
+    }
+
+    List<ID> newIdOf(nodeNum);
+    for (ID i = 0; i < nodeNum; ++i) { newIdOf[order[i]] = nodeNum - 1 - i; }
+    return newIdOf;
+}
+
+void NodeOrder::renumber(pb::PCenter::UndirectGraph &graph, const List<ID> &newIdOf) {
+    for (auto e = graph.mutable_edges()->begin(); e != graph.mutable_edges()->end(); ++e) {
+        e->set_source(newIdOf[e->source()]);
+        e->set_target(newIdOf[e->target()]);
+    }
+
+    if (graph.nodes().empty()) { return; }
+    List<ID> oldIdOf(inverse(newIdOf));
+    google::protobuf::RepeatedPtrField<pb::PCenter::Node> nodes;
+    for (ID n = 0; n < static_cast<ID>(oldIdOf.size()); ++n) { *nodes.Add() = graph.nodes(oldIdOf[n]); }
+    graph.mutable_nodes()->Swap(&nodes);
+}
+
+List<ID> NodeOrder::inverse(const List<ID> &order) {
+    List<ID> inv(order.size());
+    for (ID i = 0; i < static_cast<ID>(order.size()); ++i) { inv[order[i]] = i; }
+    return inv;
+}
+
+}
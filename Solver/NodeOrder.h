@@ -0,0 +1,38 @@
+////////////////////////////////
+/// usage : 1.	renumber the nodes so that the nodes close to each other get close ids,
+///             which makes the rows of the distance matrices visited by the search local in memory.
+///
+/// note  : 1.	an order is given as newIdOf[oldId].
+////////////////////////////////
+
+#ifndef SMART_SZX_P_CENTER_NODE_ORDER_H
+#define SMART_SZX_P_CENTER_NODE_ORDER_H
+
+
+#include "Config.h"
+
+#include "Common.h"
+#include "Utility.h"
+#include "PCenter.pb.h"
+
+
+namespace szx {
+
+class NodeOrder {
+public:
+    // sort the nodes along the Hilbert curve over the bounding box of the coordinates.
+    static List<ID> hilbert(const pb::PCenter::UndirectGraph &graph);
+    // reverse Cuthill-McKee order of the edges, which keeps the bandwidth of the adjacency matrix small.
+    static List<ID> reverseCuthillMcKee(const pb::PCenter::UndirectGraph &graph);
+
+    // relabel the nodes and the endpoints of the edges in place.
+    static void renumber(pb::PCenter::UndirectGraph &graph, const List<ID> &newIdOf);
+
+    // oldIdOf[newId] from newIdOf[oldId] and vice versa.
+    static List<ID> inverse(const List<ID> &order);
+};
+
+}
+
+
+#endif // SMART_SZX_P_CENTER_NODE_ORDER_H
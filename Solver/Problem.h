@@ -46,6 +46,19 @@ public:
             ofs << protobufToJson(submission, false) << std::endl << protobufToJson(*this);
             return true;
         }
+        // read the file written by save(). the radius is left for the solver to evaluate.
+        bool load(const String &path, pb::Submission &submission) {
+            std::ifstream ifs(path);
+            if (!ifs.is_open()) { return false; }
+
+            String line;
+            std::getline(ifs, line);
+            jsonToProtobuf(line, submission);
+            std::ostringstream oss;
+            oss << ifs.rdbuf();
+            jsonToProtobuf(oss.str(), *this);
+            return true;
+        }
 
         ID coverRadius = 0;
     };
@@ -0,0 +1,86 @@
+#include "RadiusBound.h"
+
+#include <algorithm>
+
+#include "Problem.h"
+#include "CoverageBitset.h"
+
+
+using namespace std;
+
+
+namespace szx {
+
+Length RadiusBound::lowerBound(const LargeArr2D<Length> &G, ID centerNum, const Terminator &isTimeOut) {
+    Length lb = nearestNeighborBound(G, centerNum);
+    Length ub = farthestFirstRadius(G, centerNum);
+    while ((lb < ub) && !isTimeOut()) { // lb <= optimal radius <= ub.
+        Length radius = lb + (ub - lb) / 2;
+        if (isPackable(G, centerNum, radius)) {
+            lb = radius + 1;
+        } else { // the greedy packing may miss a larger one, so ub is only a guide.
+            ub = radius;
+        }
+    }
+    return lb;
+}
+
+Length RadiusBound::nearestNeighborBound(const LargeArr2D<Length> &G, ID centerNum) {
+    ID nodeNum = G.size1();
+    return nearestNeighborBound(nodeNum, centerNum,
+        [&](ID src, Length *row) { copy(G[src], G[src] + nodeNum, row); }, []() { return false; });
+}
+
+Length RadiusBound::nearestNeighborBound(ID nodeNum, ID centerNum, const RowFiller &fill, const Terminator &isTimeOut) {
+    if (centerNum >= nodeNum) { return 0; }
+
+    List<Length> row(nodeNum);
+    List<Length> nearestDist;
+    nearestDist.reserve(nodeNum);
+    for (ID n = 0; (n < nodeNum) && !isTimeOut(); ++n) {
+        fill(n, row.data());
+        Length dist = Problem::MaxDistance;
+        for (ID m = 0; m < nodeNum; ++m) {
+            if ((m != n) && (row[m] < dist)) { dist = row[m]; }
+        }
+        nearestDist.push_back(dist);
+    }
+    if (static_cast<ID>(nearestDist.size()) <= centerNum) { return 0; } // too few nodes are scanned.
+    nth_element(nearestDist.begin(), nearestDist.begin() + centerNum, nearestDist.end(), greater<Length>());
+    return nearestDist[centerNum];
+}
+
+Length RadiusBound::farthestFirstRadius(const LargeArr2D<Length> &G, ID centerNum) {
+    ID nodeNum = G.size1();
+    List<Length> minDist(nodeNum, Problem::MaxDistance);
+    ID farthest = 0;
+    for (ID c = 0; (c < centerNum) && (c < nodeNum); ++c) {
+        const Length *row = G[farthest];
+        for (ID n = 0; n < nodeNum; ++n) { minDist[n] = (min)(minDist[n], row[n]); }
+        farthest = static_cast<ID>(max_element(minDist.begin(), minDist.end()) - minDist.begin());
+    }
+    return minDist[farthest];
+}
+
+bool RadiusBound::isPackable(const LargeArr2D<Length> &G, ID centerNum, Length radius) {
+    ID nodeNum = G.size1();
+    CoverageBitset coverage;
+    coverage.init(nodeNum, radius, [&](ID v) { return G[v]; });
+    List<ID> neighborNum(nodeNum);
+    for (ID n = 0; n < nodeNum; ++n) { neighborNum[n] = coverage.coverNum(n); }
+    // the nodes with fewer neighbors block fewer others.
+    List<ID> nodes(nodeNum);
+    for (ID n = 0; n < nodeNum; ++n) { nodes[n] = n; }
+    sort(nodes.begin(), nodes.end(), [&](ID l, ID r) { return neighborNum[l] < neighborNum[r]; });
+
+    List<CoverageBitset::Word> covered(coverage.getWordNum(), 0); // the neighbors of the packed nodes.
+    ID packedNum = 0;
+    for (auto n = nodes.begin(); n != nodes.end(); ++n) {
+        if (CoverageBitset::intersects(covered.data(), coverage.row(*n), coverage.getWordNum())) { continue; }
+        CoverageBitset::unite(covered.data(), coverage.row(*n), coverage.getWordNum());
+        if (++packedNum > centerNum) { return true; }
+    }
+    return false;
+}
+
+}
@@ -0,0 +1,51 @@
+////////////////////////////////
+/// usage : 1.	lower bounds of the optimal radius to stop the search once the incumbent is proven optimal.
+///
+/// note  : 1.	the bounds only compare the distances with the radius instead of relying on the
+///             triangle inequality, so the rounded distances of geometrical graphs need no slack.
+///         2.	at most p nodes are centers, so the radius is no less than the (p+1)_th largest
+///             distance from a node to its nearest other node. it is also no less than that of any
+///             subset of the nodes, so it only needs one row at a time and can stop anytime.
+///         3.	if more than p nodes have pairwise disjoint neighborhoods within radius r, no p centers
+///             cover them all, so the optimal radius is greater than r. the packing is found greedily
+///             on the coverage bitsets and the largest such r is searched by bisection below the
+///             radius of the farthest first centers (Gonzalez).
+////////////////////////////////
+
+#ifndef SMART_SZX_P_CENTER_RADIUS_BOUND_H
+#define SMART_SZX_P_CENTER_RADIUS_BOUND_H
+
+
+#include "Config.h"
+
+#include <functional>
+
+#include "Common.h"
+#include "Utility.h"
+
+
+namespace szx {
+
+class RadiusBound {
+public:
+    using Terminator = std::function<bool()>;
+    using RowFiller = std::function<void(ID src, Length *row)>;
+
+
+    // the best bound found before isTimeOut() returns true.
+    static Length lowerBound(const LargeArr2D<Length> &G, ID centerNum, const Terminator &isTimeOut);
+
+    static Length nearestNeighborBound(const LargeArr2D<Length> &G, ID centerNum);
+    // the same bound from the rows computed on demand. the nodes scanned before isTimeOut() returns
+    // true still give a valid but weaker bound.
+    static Length nearestNeighborBound(ID nodeNum, ID centerNum, const RowFiller &fill, const Terminator &isTimeOut);
+    // the radius of the centers picked farthest first, which is an upper bound.
+    static Length farthestFirstRadius(const LargeArr2D<Length> &G, ID centerNum);
+    // return true if more than centerNum nodes with pairwise disjoint neighborhoods are found.
+    static bool isPackable(const LargeArr2D<Length> &G, ID centerNum, Length radius);
+};
+
+}
+
+
+#endif // SMART_SZX_P_CENTER_RADIUS_BOUND_H
@@ -0,0 +1,98 @@
+////////////////////////////////
+/// usage : 1.	keep the most recently used rows of a matrix whose rows are filled on demand.
+///
+/// note  : 1.	the pointer returned by row() is valid until the next call of row() evicts it,
+///             so the capacity should be no less than the number of rows used at the same time.
+////////////////////////////////
+
+#ifndef SMART_SZX_P_CENTER_ROW_CACHE_H
+#define SMART_SZX_P_CENTER_ROW_CACHE_H
+
+
+#include "Config.h"
+
+#include <functional>
+
+#include "Common.h"
+#include "Utility.h"
+
+
+namespace szx {
+
+class RowCache {
+public:
+    using RowFiller = std::function<void(ID rowId, Length *row)>;
+
+
+    static constexpr ID InvalidId = -1;
+
+
+    RowCache() : capacity(0), hitCount(0), missCount(0) {}
+
+
+    void init(ID rowNumber, ID rowLength, ID slotNumber, const RowFiller &rowFiller) {
+        capacity = (std::min)(rowNumber, slotNumber);
+        fill = rowFiller;
+        slots.init(capacity, rowLength);
+        slotOfRow.assign(rowNumber, InvalidId);
+        rowOfSlot.assign(capacity, InvalidId);
+        // slot capacity is the sentinel of the circular list ordered by recency.
+        prev.resize(capacity + 1);
+        next.resize(capacity + 1);
+        for (ID s = 0; s <= capacity; ++s) {
+            prev[s] = (s + capacity) % (capacity + 1);
+            next[s] = (s + 1) % (capacity + 1);
+        }
+    }
+
+    bool isEnabled() const { return (capacity > 0); }
+
+    const Length* row(ID r) {
+        ID s = slotOfRow[r];
+        if (s != InvalidId) {
+            ++hitCount;
+        } else { // reuse the least recently used slot.
+            ++missCount;
+            s = prev[capacity];
+            if (rowOfSlot[s] != InvalidId) { slotOfRow[rowOfSlot[s]] = InvalidId; }
+            rowOfSlot[s] = r;
+            slotOfRow[r] = s;
+            fill(r, slots[s]);
+        }
+        moveToFront(s);
+        return slots[s];
+    }
+
+    ID getCapacity() const { return capacity; }
+    long long getHitCount() const { return hitCount; }
+    long long getMissCount() const { return missCount; }
+
+protected:
+    void moveToFront(ID s) {
+        if (next[capacity] == s) { return; }
+        next[prev[s]] = next[s];
+        prev[next[s]] = prev[s];
+        prev[s] = capacity;
+        next[s] = next[capacity];
+        prev[next[capacity]] = s;
+        next[capacity] = s;
+    }
+
+
+    ID capacity;
+    RowFiller fill;
+
+    LargeArr2D<Length> slots; // the rows of G on demand.
+    List<ID> slotOfRow;
+    List<ID> rowOfSlot;
+    List<ID> prev;
+    List<ID> next;
+
+    long long hitCount;
+    long long missCount;
+};
+
+}
+
+
+#endif // SMART_SZX_P_CENTER_ROW_CACHE_H
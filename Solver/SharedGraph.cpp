@@ -0,0 +1,225 @@
+#include "SharedGraph.h"
+
+#include <chrono>
+#include <thread>
+#include <cstdio>
+
+#if _OS_GNU_LINUX
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif // _OS_GNU_LINUX
+
+
+using namespace std;
+
+
+namespace szx {
+
+#if _OS_GNU_LINUX
+static constexpr auto PollInterval = chrono::milliseconds(10);
+
+static bool isProcessAlive(pid_t pid) { return (kill(pid, 0) == 0) || (errno == EPERM); }
+#endif // _OS_GNU_LINUX
+
+SharedGraph::Ptr SharedGraph::attach(Hash graphHash, ID nodeNum, Scope scope, const Builder &build) {
+    static mutex registryMutex;
+    static Map<Hash, weak_ptr<SharedGraph>> registry;
+
+    shared_ptr<SharedGraph> graph;
+    {
+        lock_guard<mutex> registryGuard(registryMutex);
+        for (auto g = registry.begin(); g != registry.end();) { // forget the released graphs.
+            g = g->second.expired() ? registry.erase(g) : ++g;
+        }
+        weak_ptr<SharedGraph> &entry(registry[graphHash]);
+        graph = entry.lock();
+        if (!graph) {
+            graph.reset(new SharedGraph(graphHash, nodeNum));
+            entry = graph;
+        }
+    }
+    call_once(graph->built, [&]() { graph->build(scope, build); });
+    return graph;
+}
+
+void SharedGraph::build(Scope scope, const Builder &build) {
+    if ((scope == Scope::CrossProcess) && attachSegment(build)) { return; }
+    build(G, sortedG);
+}
+
+String SharedGraph::segmentName() const {
+    char name[48];
+    snprintf(name, sizeof(name), "/szx.pcenter.%016llx", static_cast<unsigned long long>(graphHash));
+    return name;
+}
+
+bool SharedGraph::attachSegment(const Builder &build) {
+    #if _OS_GNU_LINUX
+    static constexpr auto CreatorStartTimeout = chrono::seconds(5); // between creating and mapping the segment.
+    static_assert(sizeof(Header) <= DataOffset, "the header overlaps the matrices.");
+
+    size_t matSize = sizeof(Length) * static_cast<size_t>(nodeNum) * nodeNum;
+    size_t size = DataOffset + 2 * matSize;
+    String name(segmentName());
+    auto startDeadline = chrono::steady_clock::now() + CreatorStartTimeout;
+
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    bool isCreator = (fd >= 0);
+    if (isCreator) {
+        if (ftruncate(fd, size) != 0) { ::close(fd); shm_unlink(name.c_str()); return false; }
+    } else {
+        fd = shm_open(name.c_str(), O_RDWR, 0600);
+        if (fd < 0) { return false; }
+        // the creator may not have resized the segment yet.
+        for (;;) {
+            struct stat st;
+            if (fstat(fd, &st) != 0) { ::close(fd); return false; }
+            if (static_cast<size_t>(st.st_size) == size) { break; }
+            if (st.st_size != 0) { ::close(fd); return false; } // another graph with the same hash.
+            if (chrono::steady_clock::now() > startDeadline) { // the creator died before resizing it.
+                ::close(fd);
+                shm_unlink(name.c_str());
+                return false;
+            }
+            this_thread::sleep_for(PollInterval);
+        }
+    }
+    void *addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        if (isCreator) { shm_unlink(name.c_str()); }
+        return false;
+    }
+    segment = static_cast<char*>(addr);
+    segmentSize = size;
+
+    Header *header = reinterpret_cast<Header*>(segment);
+    Length *mat = reinterpret_cast<Length*>(segment + DataOffset);
+    if (isCreator) { header->creatorPid.store(getpid()); } // the joiners wait on it before it is built.
+    lock(header);
+    // the joiners may have recorded themselves in the zero-filled header already.
+    bool isJoined = (header->state.load() != State::Unlinking) && addPid(header);
+    unlock(header);
+    if (!isJoined) {
+        if (isCreator) { shm_unlink(name.c_str()); }
+        munmap(segment, segmentSize);
+        segment = nullptr;
+        segmentSize = 0;
+        return false;
+    }
+    if (isCreator) {
+        header->magic = Magic;
+        header->version = Version;
+        header->nodeNum = nodeNum;
+        header->lengthSize = sizeof(Length);
+        header->graphHash = graphHash;
+        G.attach(nodeNum, nodeNum, mat);
+        sortedG.attach(nodeNum, nodeNum, mat + G.size());
+        int building = State::Building;
+        try {
+            build(G, sortedG);
+        } catch (...) {
+            header->state.compare_exchange_strong(building, State::Failed);
+            detachSegment();
+            throw;
+        }
+        // keep the matrices even if a joiner gave the segment up for a slow start.
+        header->state.compare_exchange_strong(building, State::Ready, memory_order_release);
+        return true;
+    }
+
+    int state;
+    while ((state = header->state.load(memory_order_acquire)) == State::Building) {
+        pid_t pid = header->creatorPid.load();
+        bool isCreatorDead = (pid == 0) ? (chrono::steady_clock::now() > startDeadline) : !isProcessAlive(pid);
+        if (isCreatorDead) { // the creator crashed before publishing it.
+            lock(header);
+            int building = State::Building;
+            if (header->state.compare_exchange_strong(building, State::Unlinking)) { shm_unlink(name.c_str()); }
+            unlock(header);
+            break;
+        }
+        this_thread::sleep_for(PollInterval);
+    }
+    if ((state != State::Ready) || (header->magic != Magic) || (header->version != Version)
+        || (header->nodeNum != nodeNum) || (header->lengthSize != sizeof(Length)) || (header->graphHash != graphHash)) {
+        detachSegment();
+        return false;
+    }
+    G.attach(nodeNum, nodeNum, mat);
+    sortedG.attach(nodeNum, nodeNum, mat + G.size());
+    return true;
+    #else
+    // EXTEND[szx][5]: use CreateFileMapping() with a name on Windows.
+    return false;
+    #endif // _OS_GNU_LINUX
+}
+
+void SharedGraph::detachSegment() {
+    if (segment == nullptr) { return; }
+    G.clear();
+    sortedG.clear();
+    #if _OS_GNU_LINUX
+    Header *header = reinterpret_cast<Header*>(segment);
+    lock(header);
+    if (removePid(header) && (header->state.exchange(State::Unlinking) != State::Unlinking)) {
+        shm_unlink(segmentName().c_str());
+    }
+    unlock(header);
+    munmap(segment, segmentSize);
+    #endif // _OS_GNU_LINUX
+    segment = nullptr;
+    segmentSize = 0;
+}
+
+void SharedGraph::lock(Header *header) {
+    #if _OS_GNU_LINUX
+    int self = getpid();
+    for (;;) {
+        int holder = 0;
+        if (header->lockPid.compare_exchange_strong(holder, self)) { return; }
+        // take the lock over from a killed holder. the pids and state stay consistent since each update is atomic.
+        if (!isProcessAlive(holder) && header->lockPid.compare_exchange_strong(holder, self)) { return; }
+        this_thread::sleep_for(PollInterval);
+    }
+    #endif // _OS_GNU_LINUX
+}
+
+void SharedGraph::unlock(Header *header) {
+    header->lockPid.store(0);
+}
+
+bool SharedGraph::addPid(Header *header) {
+    #if _OS_GNU_LINUX
+    for (auto &pid : header->pids) {
+        int p = pid.load();
+        if ((p == 0) || !isProcessAlive(p)) { pid.store(getpid()); return true; }
+    }
+    #endif // _OS_GNU_LINUX
+    return false;
+}
+
+bool SharedGraph::removePid(Header *header) {
+    bool isLast = true;
+    #if _OS_GNU_LINUX
+    int self = getpid();
+    bool isRemoved = false;
+    for (auto &pid : header->pids) {
+        int p = pid.load();
+        if (p == 0) { continue; }
+        if ((!isRemoved && (p == self)) || !isProcessAlive(p)) {
+            pid.store(0);
+            isRemoved |= (p == self);
+        } else {
+            isLast = false;
+        }
+    }
+    #endif // _OS_GNU_LINUX
+    return isLast;
+}
+
+}
@@ -0,0 +1,120 @@
+////////////////////////////////
+/// usage : 1.	immutable preprocessed distance matrix and sorted neighbor lists shared by
+///             the solvers of the same graph instead of being rebuilt by each of them.
+///         2.	the solvers in the same process share the object through a registry keyed by
+///             the hash of the graph. the solvers in other processes attach to a POSIX shared
+///             memory segment named after the hash.
+///
+/// note  : 1.	the graph is released when the last solver referring to it is destroyed,
+///             and the segment is unlinked when the last live process detaches from it.
+///         2.	a segment left by a crashed process is reused if it is complete, or removed
+///             and rebuilt if its creator died before publishing it.
+///         3.	the segment records the pids of the attached processes instead of a counter, so
+///             the slots of the killed ones are reclaimed by the next attach or detach. if every
+///             process attached to a segment is killed, it stays in /dev/shm until another solver
+///             of the same graph attaches and detaches, or it is removed by shm_unlink manually.
+///         4.	the pids and the state change under a lock in the header, whose holder is replaced
+///             if it dies. the segment is marked Unlinking before its name is removed, so a process
+///             attaching at the same time backs off, and the name is removed exactly once.
+////////////////////////////////
+
+#ifndef SMART_SZX_P_CENTER_SHARED_GRAPH_H
+#define SMART_SZX_P_CENTER_SHARED_GRAPH_H
+
+
+#include "Config.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "Common.h"
+#include "Utility.h"
+#include "DistanceCache.h"
+
+
+namespace szx {
+
+class SharedGraph {
+public:
+    using Hash = DistanceCache::Hash;
+    using Ptr = std::shared_ptr<const SharedGraph>;
+    // fill the matrices. they are attached to the shared memory segment if there is one,
+    // otherwise they are empty and the builder allocates them.
+    using Builder = std::function<void(LargeArr2D<Length> &adjMat, LargeArr2D<Length> &sortedAdjList)>;
+
+    enum Scope { InProcess, CrossProcess };
+
+
+    static constexpr std::uint32_t Magic = 0x47535a53; // "SZSG".
+    static constexpr std::uint32_t Version = 3;
+
+
+    // return the live graph with the same hash or build a new one.
+    // concurrent callers for the same graph wait for a single build.
+    static Ptr attach(Hash graphHash, ID nodeNum, Scope scope, const Builder &build);
+
+
+    SharedGraph(const SharedGraph &) = delete;
+    SharedGraph& operator=(const SharedGraph &) = delete;
+    ~SharedGraph() { detachSegment(); }
+
+
+    const LargeArr2D<Length>& adjMat() const { return G; }
+    const LargeArr2D<Length>& sortedAdjList() const { return sortedG; }
+
+    // the matrices are in a shared memory segment instead of the heap of this process.
+    bool isCrossProcess() const { return (segment != nullptr); }
+
+protected:
+    enum State { Building = 0, Ready, Failed, Unlinking }; // the zero-filled new segment is building.
+
+    static constexpr int MaxProcessNum = 1000; // the others build their own graphs.
+
+    struct Header {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::int32_t nodeNum;
+        std::int32_t lengthSize; // sizeof(Length) when the segment is built.
+        Hash graphHash;
+        std::atomic<std::int32_t> creatorPid; // 0 until the creator maps the segment.
+        std::atomic<std::int32_t> state;
+        std::atomic<std::int32_t> lockPid; // the process updating pids or state. 0 if it is unlocked.
+        std::atomic<std::int32_t> pids[MaxProcessNum]; // the processes attached to the segment. 0 for free slots.
+    };
+    static constexpr size_t DataOffset = 64 * Memory::CacheLineSize; // align the matrices to the page.
+
+
+    SharedGraph(Hash hash, ID nodeNumber) : graphHash(hash), nodeNum(nodeNumber), segment(nullptr), segmentSize(0) {}
+
+    void build(Scope scope, const Builder &build);
+
+    // create or attach to the segment of the graph. return false if it is unavailable.
+    bool attachSegment(const Builder &build);
+    void detachSegment();
+    static void lock(Header *header);
+    static void unlock(Header *header);
+    // record this process in the header under the lock. return false if there is no free slot.
+    static bool addPid(Header *header);
+    // erase this process and the dead ones under the lock. return true if no live process is left.
+    static bool removePid(Header *header);
+
+    String segmentName() const;
+
+
+    Hash graphHash;
+    ID nodeNum;
+
+    LargeArr2D<Length> G;
+    LargeArr2D<Length> sortedG;
+    std::once_flag built;
+
+    char *segment;
+    size_t segmentSize;
+};
+
+}
+
+
+#endif // SMART_SZX_P_CENTER_SHARED_GRAPH_H
@@ -1,13 +1,17 @@
 #include "Solver.h"
 
 #include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <string>
 #include <thread>
 #include <mutex>
+#include <tuple>
 
+#include <cctype>
+#include <csignal>
 #include <cmath>
 
 
@@ -18,6 +22,8 @@ namespace szx {
 
 #pragma region Solver::Cli
 int Solver::Cli::run(int argc, char * argv[]) {
+    handleSignals();
+
     Log(LogSwitch::Szx::Cli) << "parse command line arguments." << endl;
     Set<String> switchSet;
     Map<String, char*> optionMap({ // use string as key to compare string contents instead of pointers.
@@ -30,7 +36,22 @@ int Solver::Cli::run(int argc, char * argv[]) {
         { RunIdOption(), nullptr },
         { EnvironmentPathOption(), nullptr },
         { ConfigPathOption(), nullptr },
-        { LogPathOption(), nullptr }
+        { LogPathOption(), nullptr },
+        { CacheDirOption(), nullptr },
+        { OutOfCoreDirOption(), nullptr },
+        { LazyRowOption(), nullptr },
+        { DistanceLayoutOption(), nullptr },
+        { RenumberOption(), nullptr },
+        { MemoryBudgetOption(), nullptr },
+        { NumaOption(), nullptr },
+        { AffinityOption(), nullptr },
+        { ShareGraphOption(), nullptr },
+        { SweepOption(), nullptr },
+        { WarmStartOption(), nullptr },
+        { StreamOption(), nullptr },
+        { CheckpointOption(), nullptr },
+        { CheckpointIntervalOption(), nullptr },
+        { ResumeOption(), nullptr }
     });
 
     for (int i = 1; i < argc; ++i) { // skip executable name.
@@ -62,6 +83,8 @@ int Solver::Cli::run(int argc, char * argv[]) {
     Problem::Input input;
     if (!input.load(env.instPath)) { return -1; }
 
+    if (!env.sweep.empty()) { return sweep(input, env, cfg); }
+
     Solver solver(input, env, cfg);
     solver.solve();
 
@@ -78,6 +101,89 @@ int Solver::Cli::run(int argc, char * argv[]) {
 
     return 0;
 }
+
+static void requestStop(int signum) {
+    Solver::isStopRequested = true;
+    signal(signum, SIG_DFL); // a second signal terminates the process at once.
+}
+
+static void requestProgress(int signum) {
+    Solver::isProgressRequested = true;
+    signal(signum, requestProgress); // some platforms reset the handler on delivery.
+}
+
+void Solver::Cli::handleSignals() {
+    signal(SIGTERM, requestStop);
+    signal(SIGINT, requestStop);
+    #ifdef SIGUSR1
+    signal(SIGUSR1, requestProgress);
+    #endif // SIGUSR1
+}
+
+int Solver::Cli::sweep(const Problem::Input &input, const Environment &env, const Configuration &cfg) {
+    List<int> centerNums;
+    for (int p : System::parseIdList(env.sweep)) {
+        if ((p > 0) && (p <= input.graph().nodenum())) { centerNums.push_back(p); }
+    }
+    if (centerNums.empty()) { return -1; }
+
+    // the solvers split the threads and reuse the distances built by the first one.
+    int solverNum = (min)(env.jobNum, static_cast<int>(centerNums.size()));
+    Environment sweepEnv(env);
+    sweepEnv.jobNum = (max)(1, env.jobNum / solverNum);
+    if (sweepEnv.shareGraph.empty()) { sweepEnv.shareGraph = Environment::ShareInProcess(); }
+
+    SharedGraph::Ptr graph; // keep the distances alive between the solvers running in sequence.
+    Map<int, List<ID>> solved; // the centers of the finished runs to seed the runs of the nearby center numbers.
+    mutex sweepMutex;
+    atomic<size_t> next(0);
+    auto solveNext = [&]() {
+        for (size_t i = next++; (i < centerNums.size()) && !isStopRequested; i = next++) {
+            Problem::Input pInput(input);
+            pInput.set_centernum(centerNums[i]);
+            Environment pEnv(sweepEnv);
+            pEnv.slnPath = env.solutionPathOfSweep(centerNums[i]);
+            pEnv.checkpointPath = Environment::pathOfSweep(env.checkpointPath, centerNums[i]); // one file per p.
+            pEnv.resumePath = Environment::pathOfSweep(env.resumePath, centerNums[i]);
+
+            Log(LogSwitch::Szx::Input) << "solve " << env.instPath << " for p=" << centerNums[i] << "." << endl;
+            Solver solver(pInput, pEnv, cfg);
+            {
+                lock_guard<mutex> sweepGuard(sweepMutex);
+                auto seed = solved.lower_bound(centerNums[i]);
+                if ((seed == solved.end()) || ((seed != solved.begin())
+                    && ((centerNums[i] - prev(seed)->first) <= (seed->first - centerNums[i])))) {
+                    if (seed != solved.begin()) { --seed; }
+                }
+                if (seed != solved.end()) { solver.setSeed(seed->second); }
+            }
+            solver.solve();
+            {
+                lock_guard<mutex> sweepGuard(sweepMutex);
+                if (!graph) { graph = solver.aux.sharedGraph; }
+                solved[centerNums[i]].assign(solver.output.centers().begin(), solver.output.centers().end());
+            }
+
+            pb::Submission submission;
+            submission.set_thread(to_string(pEnv.jobNum));
+            submission.set_instance(pEnv.friendlyInstName());
+            submission.set_duration(to_string(solver.timer.elapsedSeconds()) + "s");
+
+            solver.output.save(pEnv.slnPath, submission);
+            #if SZX_DEBUG
+            solver.output.save(pEnv.solutionPathWithTime(), submission);
+            solver.record();
+            #endif // SZX_DEBUG
+        }
+    };
+
+    List<thread> threadList;
+    threadList.reserve(solverNum);
+    for (int i = 0; i < solverNum; ++i) { threadList.emplace_back(solveNext); }
+    for (auto t = threadList.begin(); t != threadList.end(); ++t) { t->join(); }
+
+    return 0;
+}
 #pragma endregion Solver::Cli
 
 #pragma region Solver::Environment
@@ -114,6 +220,51 @@ void Solver::Environment::load(const Map<String, char*> &optionMap) {
     str = optionMap.at(Cli::LogPathOption());
     if (str != nullptr) { logPath = str; }
 
+    str = optionMap.at(Cli::CacheDirOption());
+    if (str != nullptr) { cacheDir = str; }
+
+    str = optionMap.at(Cli::OutOfCoreDirOption());
+    if (str != nullptr) { oocDir = str; }
+
+    str = optionMap.at(Cli::LazyRowOption());
+    if (str != nullptr) { rowCacheMb = atoi(str); }
+
+    str = optionMap.at(Cli::DistanceLayoutOption());
+    if (str != nullptr) { layout = str; }
+
+    str = optionMap.at(Cli::RenumberOption());
+    if (str != nullptr) { renumber = (atoi(str) != 0); }
+
+    str = optionMap.at(Cli::MemoryBudgetOption());
+    if (str != nullptr) { memoryMb = atoi(str); }
+
+    str = optionMap.at(Cli::NumaOption());
+    if (str != nullptr) { numaPolicy = str; }
+
+    str = optionMap.at(Cli::AffinityOption());
+    if (str != nullptr) { affinity = str; }
+
+    str = optionMap.at(Cli::ShareGraphOption());
+    if (str != nullptr) { shareGraph = str; }
+
+    str = optionMap.at(Cli::SweepOption());
+    if (str != nullptr) { sweep = str; }
+
+    str = optionMap.at(Cli::WarmStartOption());
+    if (str != nullptr) { warmStartPath = str; }
+
+    str = optionMap.at(Cli::StreamOption());
+    if (str != nullptr) { streamSolution = (atoi(str) != 0); }
+
+    str = optionMap.at(Cli::CheckpointOption());
+    if (str != nullptr) { checkpointPath = str; }
+
+    str = optionMap.at(Cli::CheckpointIntervalOption());
+    if (str != nullptr) { checkpointInterval = atof(str); }
+
+    str = optionMap.at(Cli::ResumeOption());
+    if (str != nullptr) { resumePath = str; }
+
     calibrate();
 }
 
@@ -131,29 +282,71 @@ void Solver::Environment::save(const String &filePath) const {
     // EXTEND[szx][8]: save environment to file.
 }
 void Solver::Environment::calibrate() {
-    // adjust thread number.
-    int threadNum = thread::hardware_concurrency();
+    // adjust thread number to the cpus allowed by the affinity mask and the cgroup quota.
+    int threadNum = System::availableCpuNum();
     if ((jobNum <= 0) || (jobNum > threadNum)) { jobNum = threadNum; }
 
-    // adjust timeout.
-    msTimeout -= Environment::SaveSolutionTimeInMillisecond;
+    // the solver reserves the time for saving the solution by measuring it.
 }
 #pragma endregion Solver::Environment
 
 #pragma region Solver::Configuration
 void Solver::Configuration::load(const String &filePath) {
-    // EXTEND[szx][5]: load configuration from file.
-    // EXTEND[szx][8]: check file existence first.
+    ifstream ifs(filePath);
+    if (!ifs.is_open()) { return; } // keep the default configuration.
+
+    // each row is a key and a value, e.g., "ttn;2.5". the keys are the same as in toBriefStr().
+    CsvReader cr;
+    const List<CsvReader::Row> &rows(cr.scan(ifs));
+    for (auto r = rows.begin(); r != rows.end(); ++r) {
+        if (r->size() < 2) { continue; }
+        String key(r->at(0));
+        const char *value = r->at(1);
+        if (key == "alg") {
+            alg = static_cast<Algorithm>(atoi(value));
+        } else if (key == "job") {
+            threadNumPerWorker = (max)(1, atoi(value));
+        } else if (key == "lm") {
+            landmarkNum = atoi(value);
+        } else if (key == "ttn") {
+            tenureNodeCoef = atof(value);
+        } else if (key == "ttp") {
+            tenureCenterCoef = atof(value);
+        } else if (key == "stag") {
+            maxStagnation = atoi(value);
+        } else if (key == "opt") {
+            stopAtOptimum = (atoi(value) != 0);
+        } else if (key == "target") {
+            targetRadius = atof(value);
+        } else if (key == "cstag") {
+            coverStagnation = atoi(value);
+        } else {
+            Log(LogSwitch::Szx::Config) << "ignore unknown configuration " << key << " in " << filePath << endl;
+        }
+    }
 }
 
 void Solver::Configuration::save(const String &filePath) const {
-    // EXTEND[szx][5]: save configuration to file.
+    ofstream ofs(filePath);
+    String brief(toBriefStr()); // "key=value;key=value".
+    replace(brief.begin(), brief.end(), ';', '\n');
+    replace(brief.begin(), brief.end(), '=', CsvReader::CommaChar);
+    ofs << brief << endl;
 }
 #pragma endregion Solver::Configuration
 
 #pragma region Solver
+thread_local ID Solver::numaNode = 0;
+atomic<bool> Solver::isStopRequested(false);
+atomic<bool> Solver::isProgressRequested(false);
+
 bool Solver::solve() {
     init();
+    if (!env.affinity.empty()) { planAffinity(); }
+    if (aux.isResumed) { // the workers share aux, so the state is rebuilt once before they start.
+        aux.resumeIteration = restoreCheckpoint();
+        Log(LogSwitch::Szx::Framework) << "resume from iteration " << aux.resumeIteration << " with radius " << aux.scBest << "." << endl;
+    }
 
     int workerNum = (max)(1, env.jobNum / cfg.threadNumPerWorker);
     cfg.threadNumPerWorker = env.jobNum / workerNum;
@@ -169,6 +362,7 @@ bool Solver::solve() {
         threadList.emplace_back([&, i]() { success[i] = optimize(solutions[i], i); });
     }
     for (int i = 0; i < workerNum; ++i) { threadList.at(i).join(); }
+    if (aux.writer) { aux.writer->flush(); } // the final save must not be overwritten by a streamed one.
 
    // Log(LogSwitch::Szx::Framework) << "collect best result among all workers." << endl;
     int bestIndex = -1;
@@ -187,6 +381,34 @@ bool Solver::solve() {
     return true;
 }
 
+void Solver::reportProgress(int iteration) const {
+	double elapsed = timer.elapsedSeconds();
+	cerr << env.friendlyInstName() << " iter=" << iteration
+		<< " iter/s=" << iteration / (max)(elapsed, 1e-3)
+		<< " cur=" << aux.scCur / aux.objScale
+		<< " best=" << aux.scBest / aux.objScale
+		<< " elapsed=" << elapsed << "s" << endl;
+}
+
+void Solver::reserveSaveTime() {
+	Solution sln(this);
+	for (const auto &s : aux.bestS) { sln.add_centers(aux.oldIdOf.empty() ? s : aux.oldIdOf[s]); }
+	pb::Submission submission;
+	submission.set_thread(to_string(env.jobNum));
+	submission.set_instance(env.friendlyInstName());
+	submission.set_duration(to_string(timer.elapsedSeconds()) + "s");
+
+	// the same serialization as Problem::Output::save().
+	auto begin = chrono::steady_clock::now();
+	String json(protobufToJson(submission, false) + "\n" + protobufToJson(sln));
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+
+	double reserve = Environment::SaveSolutionCostFactor * seconds
+		+ Environment::SaveSolutionMarginInMillisecond / Timer::MillisecondsPerSecond;
+	aux.saveTime = Timer::toMillisecond(reserve);
+	Log(LogSwitch::Szx::Framework) << "reserve " << reserve << " seconds to save " << json.size() << " bytes." << endl;
+}
+
 void Solver::record() const {
     #if SZX_DEBUG
     int generation = 0;
@@ -260,15 +482,21 @@ bool Solver::check(Length &checkerObj) const {
 void Solver::addFacility(const int f)
 {	// ӷ
 	aux.S.insert(f);
+	if (aux.voronoi.isEnabled()) {
+		aux.voronoi.addCenter(f);
+		aux.scCur = *max_element(aux.D.begin(0), aux.D.end(0));
+		return;
+	}
+	const Length *fRow = distRow(f);
 	for (int v = 0; v < aux.nodeNum; ++v) {
-		if (aux.G.at(f, v) < aux.D.at(0, v)) {
+		if (fRow[v] < aux.D.at(0, v)) {
 			aux.D.at(1, v) = aux.D.at(0, v);
 			aux.F.at(1, v) = aux.F.at(0, v);
-			aux.D.at(0, v) = aux.G.at(f, v);
+			aux.D.at(0, v) = fRow[v];
 			aux.F.at(0, v) = f;
 		}
-		else if (aux.G.at(f, v) < aux.D.at(1, v)) {
-			aux.D.at(1, v) = aux.G.at(f, v);
+		else if (fRow[v] < aux.D.at(1, v)) {
+			aux.D.at(1, v) = fRow[v];
 			aux.F.at(1, v) = f;
 		}
 	}
@@ -280,13 +508,14 @@ void Solver::findNext(const int v, const int f)
 	vector<int> distToServer;
 	int tmpDist = Problem::MaxDistance;
 	for (const auto &s : aux.S) {
-		if (s != f) {
-			if (aux.G.at(v, s) < tmpDist) {
-				tmpDist = aux.G.at(v, s);
+		if (s != f) { // G is symmetric and reading the rows of centers keeps them hot in cache.
+			Length dist = distRow(s)[v];
+			if (dist < tmpDist) {
+				tmpDist = dist;
 				distToServer.clear();
 				distToServer.push_back(s);
 			}
-			else if (aux.G.at(v, s) == tmpDist) {
+			else if (dist == tmpDist) {
 				distToServer.push_back(s);
 			}
 		}
@@ -299,6 +528,11 @@ void Solver::findNext(const int v, const int f)
 void Solver::removeFacility(const int f)
 {	// ɾһ
 	aux.S.erase(f);
+	if (aux.voronoi.isEnabled()) {
+		aux.voronoi.removeCenter(f);
+		aux.scCur = *max_element(aux.D.begin(0), aux.D.end(0));
+		return;
+	}
 	for (int v = 0; v < aux.nodeNum; ++v) {
 		if (f == aux.F.at(0, v)) {
 			aux.D.at(0, v) = aux.D.at(1, v);
@@ -314,34 +548,186 @@ void Solver::removeFacility(const int f)
 
 void Solver::candidate()
 {	// Һѡ
-	aux.candidates.clear();
+	aux.criticals.clear();
 	for (int i = 0; i < aux.nodeNum; ++i) {
 		if (aux.D.at(0, i) == aux.scCur) {
-			aux.candidates.push_back(i);
+			aux.criticals.push_back(i);
 		}
 	}
-	int vertex = aux.candidates[rand.pick(aux.candidates.size())];
+	int vertex = aux.criticals[rand.pick(aux.criticals.size())];
 	aux.candidates.clear();
 
 	int server = aux.F.at(0, vertex);
-	auto index = find(aux.sortedG.begin(vertex), aux.sortedG.end(vertex), server);
-	for (auto i = aux.sortedG.begin(vertex); i < index; ++i) {
+	if (aux.voronoi.isEnabled()) { // search the ball around the vertex within the distance to its server.
+		Length serverDist = aux.D.at(0, vertex);
+		aux.voronoi.forEachNodeWithin(vertex, serverDist, [&](ID i, Length dist) {
+			if (((dist < serverDist) || (i < server)) && (aux.S.find(i) == aux.S.end())) {
+				aux.candidates.push_back(i);
+			}
+		});
+		return;
+	}
+	if (!aux.nearBegin.empty() && (aux.D.at(0, vertex) <= aux.nearRadius)) { // the server may be in the truncated list.
+		auto index = find(aux.nearNodes.begin() + aux.nearBegin[vertex], aux.nearNodes.begin() + aux.nearBegin[vertex + 1], server);
+		if (index != aux.nearNodes.begin() + aux.nearBegin[vertex + 1]) {
+			for (auto i = aux.nearNodes.begin() + aux.nearBegin[vertex]; i < index; ++i) {
+				if (aux.S.find(*i) == aux.S.end()) {
+					aux.candidates.push_back(*i);
+				}
+			}
+			return;
+		}
+	}
+	if (!aux.nearBegin.empty()) { ++aux.farCandidateNum; }
+	if (aux.sortedG.empty()) { // pick the nodes ahead of the server in (distance, id) order from the row.
+		const Length *vRow = distRow(vertex);
+		Length serverDist = vRow[server];
+		for (ID i = 0; i < aux.nodeNum; ++i) {
+			if (((vRow[i] < serverDist) || ((vRow[i] == serverDist) && (i < server)))
+				&& (aux.S.find(i) == aux.S.end())) {
+				aux.candidates.push_back(i);
+			}
+		}
+		return;
+	}
+	const LargeArr2D<Length> &sortedG(localSortedG());
+	auto index = find(sortedG.begin(vertex), sortedG.end(vertex), server);
+	for (auto i = sortedG.begin(vertex); i < index; ++i) {
 		if (aux.S.find(*i) == aux.S.end()) {
 			aux.candidates.push_back(*i);
 		}
 	}
 }
 
-void Solver::initialSol()
+void Solver::initialSol(const List<ID> &seed)
 {
-	int server = rand.pick(aux.nodeNum);
-	addFacility(server);
-	for (int i = 1; i < aux.centerNum; ++i) {
+	List<ID> newIdOf(aux.oldIdOf.empty() ? List<ID>() : NodeOrder::inverse(aux.oldIdOf));
+	for (ID c : seed) {
+		if ((c < 0) || (c >= aux.nodeNum)) { continue; }
+		ID n = newIdOf.empty() ? c : newIdOf[c];
+		if (aux.S.find(n) == aux.S.end()) { addFacility(n); }
+	}
+	if (aux.S.empty()) { addFacility(rand.pick(aux.nodeNum)); }
+
+	// add the candidate which reduces the radius the most to a seed if the rows are at hand, or a random one otherwise.
+	while (static_cast<ID>(aux.S.size()) < aux.centerNum) {
 		candidate();
-		server = aux.candidates[rand.pick(aux.candidates.size())];
+		if (aux.candidates.empty()) { break; } // every node is a center.
+		ID server = aux.candidates[rand.pick(aux.candidates.size())];
+		if (!seed.empty() && !aux.G.empty()) {
+			Length bestRadius = Problem::MaxDistance;
+			for (const auto &c : aux.candidates) {
+				const Length *cRow = distRow(c);
+				Length radius = 0;
+				for (int v = 0; (v < aux.nodeNum) && (radius < bestRadius); ++v) {
+					radius = (max)(radius, (min)(aux.D.at(0, v), cRow[v]));
+				}
+				if (radius < bestRadius) {
+					bestRadius = radius;
+					server = c;
+				}
+			}
+		}
 		addFacility(server);
 	}
+
+	// drop the center whose removal increases the radius the least.
+	while (static_cast<ID>(aux.S.size()) > aux.centerNum) {
+		for (const auto &f : aux.S) { aux.M[f] = 0; }
+		for (const auto &v : aux.Nodes) {
+			if (aux.D.at(1, v) > aux.M[aux.F.at(0, v)]) {
+				aux.M[aux.F.at(0, v)] = aux.D.at(1, v);
+			}
+		}
+		ID cheapest = *aux.S.begin();
+		for (const auto &f : aux.S) {
+			if (aux.M[f] < aux.M[cheapest]) { cheapest = f; }
+		}
+		removeFacility(cheapest);
+	}
 	aux.scBest = aux.scCur;
+	aux.bestS = aux.S; // a seed may never be improved.
+}
+
+void Solver::resetCenters(const List<ID> &centers)
+{
+	aux.S.clear();
+	fill(aux.F.begin(), aux.F.end(), aux.nodeNum);
+	fill(aux.D.begin(), aux.D.end(), Problem::MaxDistance);
+	for (ID c : centers) { addFacility(c); }
+}
+
+bool Solver::decideRadius()
+{
+	// the radius of any solution is a distance in G, so only the distinct ones between the bounds are decided.
+	List<Length> radii;
+	for (ID i = 0; i < aux.nodeNum; ++i) {
+		const Length *row = aux.G[i];
+		for (ID j = 0; j < i; ++j) {
+			if ((row[j] >= aux.lowerBound) && (row[j] < aux.scBest)) { radii.push_back(row[j]); }
+		}
+	}
+	sort(radii.begin(), radii.end());
+	radii.erase(unique(radii.begin(), radii.end()), radii.end());
+
+	// radii[hi] or the best radius if hi is the end is feasible, and the radii before lo are given up.
+	size_t lo = 0;
+	size_t hi = radii.size();
+	auto isTimeOut = [this]() { return isStopRequested || (timer.restMilliseconds() <= aux.saveTime); };
+	List<ID> coverNum;
+	List<ID> centers;
+	while (lo < hi) {
+		if (isTimeOut()) { return false; }
+		size_t mid = (lo + hi) / 2;
+		countCoverers(radii[mid], coverNum);
+		if (!coverGreedily(coverNum, centers)
+			&& !aux.coverSearch.solve(aux.sortedG, coverNum, centers, cfg.coverStagnation, rand, isTimeOut)) {
+			lo = mid + 1;
+			continue;
+		}
+		resetCenters(centers);
+		aux.scBest = aux.scCur;
+		aux.bestS = aux.S;
+		hi = lower_bound(radii.begin(), radii.end(), aux.scCur) - radii.begin();
+	}
+	return true;
+}
+
+void Solver::countCoverers(Length radius, List<ID> &coverNum)
+{
+	coverNum.resize(aux.nodeNum);
+	for (ID v = 0; v < aux.nodeNum; ++v) {
+		const Length *row = aux.G[v];
+		coverNum[v] = static_cast<ID>(upper_bound(aux.sortedG.begin(v), aux.sortedG.end(v), radius,
+			[&](Length r, Length n) { return r < row[n]; }) - aux.sortedG.begin(v));
+	}
+}
+
+bool Solver::coverGreedily(const List<ID> &coverNum, List<ID> &centers)
+{
+	// add the center covering the most uncovered nodes until all nodes are covered.
+	List<ID> gain(coverNum);
+	List<bool> isCovered(aux.nodeNum, false);
+	ID uncoveredNum = aux.nodeNum;
+	centers.clear();
+	while ((uncoveredNum > 0) && (static_cast<ID>(centers.size()) < aux.centerNum)) {
+		ID c = static_cast<ID>(max_element(gain.begin(), gain.end()) - gain.begin());
+		centers.push_back(c);
+		for (auto v = aux.sortedG.begin(c); v != aux.sortedG.begin(c) + coverNum[c]; ++v) {
+			if (isCovered[*v]) { continue; }
+			isCovered[*v] = true;
+			--uncoveredNum;
+			for (auto n = aux.sortedG.begin(*v); n != aux.sortedG.begin(*v) + coverNum[*v]; ++n) { --gain[*n]; }
+		}
+	}
+	if (uncoveredNum > 0) { return false; } // the local search starts from these centers.
+
+	// the extra centers never enlarge the radius.
+	Set<ID> centerSet(centers.begin(), centers.end());
+	for (ID n = 0; static_cast<ID>(centers.size()) < aux.centerNum; ++n) {
+		if (centerSet.insert(n).second) { centers.push_back(n); }
+	}
+	return true;
 }
 
 szx::MvPair Solver::findPair(const int step)
@@ -351,7 +737,17 @@ szx::MvPair Solver::findPair(const int step)
 	newf = tabuf = noTabuf = Problem::MaxDistance;
 	aux.tabuMv.clear(); aux.noTabuMv.clear();
 	candidate();
+	if (aux.isGMapped) { // let the kernel page in the rows to be scanned in the background.
+		for (const auto &c : aux.candidates) {
+			MappedFile::advise(aux.G[c], sizeof(Length) * aux.nodeNum, MappedFile::Advice::WillNeed);
+		}
+	}
 	for (const auto &c : aux.candidates) {
+		if (aux.landmark.isEnabled() && (noTabuf < Problem::MaxDistance) && (swapLowerBound(c) > static_cast<Length>(noTabuf))) {
+			++aux.prunedCandidateNum; // all swaps with c are worse than the best non-tabu one.
+			continue;
+		}
+		++aux.evaluatedCandidateNum;
 		addFacility(c);
 		for (const auto &f : aux.S) { aux.M[f] = 0; }
 		for (const auto &v : aux.Nodes) {	// M
@@ -363,7 +759,7 @@ szx::MvPair Solver::findPair(const int step)
 			if (f != c) {	//ȥռ
 							// ǰĿ꺯ֵ
 				newf = aux.scCur < aux.M[f] ? aux.M[f] : aux.scCur;
-				if (aux.T.at(c, f) > step) {	// ǰ
+				if (tabuUntil(c, f) > step) {	// ǰ
 					if (newf < tabuf) {
 						tabuf = newf;
 						aux.tabuMv.clear();
@@ -402,16 +798,362 @@ szx::MvPair Solver::findPair(const int step)
 	return aux.noTabuMv[rand.pick(aux.noTabuMv.size())];
 }
 
-void Solver::init() {
-	aux.nodeNum = input.graph().nodenum();
-	aux.centerNum = input.centernum();
-	aux.tt = 2 * aux.nodeNum + rand.pick(aux.centerNum);
-	aux.G.init(aux.nodeNum, aux.nodeNum);
+void Solver::planLayout() {
+	if (env.memoryMb <= 0) { return; }
+
+	constexpr size_t MegaByte = 1024 * 1024;
+	size_t budget = MegaByte * env.memoryMb;
+	size_t n = aux.nodeNum;
+	size_t m = input.graph().edges().size();
+	size_t rowSize = sizeof(Length) * n;
+	size_t matSize = rowSize * n;
+	size_t minRowCache = rowSize * (aux.centerNum + 2);
+	size_t sparseT = 4 * sizeof(long long) * aux.tt; // the hash table keeps at most 2 * tt moves.
+	size_t base = sizeof(Length) * 6 * n; // F, D, M and Nodes.
+
+	struct Plan {
+		String layout;
+		size_t fixedSize; // the memory besides the row cache.
+		bool useRowCache;
+	};
+	List<Plan> plans({ // from the fastest to the slowest.
+		{ "", base + 3 * matSize, false }, // G, sortedG and T.
+		// G, T and the truncated lists. the lists take up the left memory or a quarter of n*n at least.
+		{ Environment::TruncatedLayout(), base + 2 * matSize + matSize / 4, false },
+		// a packed matrix has the same size as the 16-bit matrix without limiting the range of distances.
+		{ Environment::PackedLayout(), base + SymArr2D<Length>::flatSize(aux.nodeNum) * sizeof(Length) + sparseT, true },
+		{ Environment::LazyLayout(), base + sparseT + (Problem::isTopologicalGraph(input) ? 2 * m * (sizeof(ID) + sizeof(Length)) : 0), true }
+	});
+	if (Problem::isTopologicalGraph(input)) { // the csr adjacency and the search buffers.
+		plans.push_back({ Environment::VoronoiLayout(), base + sparseT + 2 * m * (sizeof(ID) + sizeof(Length)) + 3 * rowSize, false });
+	}
+
+	const Plan *choice = nullptr;
+	for (auto p = plans.begin(); p != plans.end(); ++p) {
+		size_t size = p->fixedSize + (p->useRowCache ? minRowCache : 0);
+		Log(LogSwitch::Preprocess) << "layout " << (p->layout.empty() ? "dense" : p->layout) << " takes " << size / MegaByte << "MB." << endl;
+		if ((choice == nullptr) && (size <= budget)) { choice = &*p; }
+	}
+	if (choice == nullptr) {
+		choice = &plans.back();
+		Log(LogSwitch::Preprocess) << "no layout fits, use the smallest one." << endl;
+	}
+
+	env.layout = choice->layout;
+	env.rowCacheMb = 0;
+	aux.rowCacheSize = 0;
+	size_t spare = (budget > choice->fixedSize) ? (budget - choice->fixedSize) : 0;
+	if (choice->useRowCache) { // keep the exact size since a small budget is less than 1MB.
+		aux.rowCacheSize = (max)(spare, minRowCache);
+		env.rowCacheMb = static_cast<int>((aux.rowCacheSize + MegaByte - 1) / MegaByte);
+	} else if (choice->layout == Environment::TruncatedLayout()) {
+		aux.nearBudget = (spare + matSize / 4) / sizeof(ID);
+	}
+	aux.plannedSize = choice->fixedSize + aux.rowCacheSize
+		+ ((choice->layout == Environment::TruncatedLayout()) ? spare : 0); // the truncated lists take the spare memory.
+	Log(LogSwitch::Preprocess) << "choose layout " << (env.layout.empty() ? "dense" : env.layout)
+		<< " with " << (choice->useRowCache ? rowCacheSlotNum() : 0) << " rows in the row cache under " << env.memoryMb << "MB." << endl;
+}
+
+void Solver::placeOnNuma() {
+	int nodeNum = Numa::nodeNum();
+	if ((nodeNum <= 1) || aux.G.empty() || aux.sortedG.empty() || aux.isGMapped || aux.sharedGraph) {
+		Log(LogSwitch::Preprocess) << "skip the numa placement for single node or absent matrices." << endl;
+		return;
+	}
+
+	size_t replicaSize = sizeof(Length) * (aux.G.size() + aux.sortedG.size()) * (nodeNum - 1);
+	size_t budget = static_cast<size_t>(env.memoryMb) * 1024 * 1024;
+	bool isReplicaFit = (env.memoryMb <= 0) || (aux.plannedSize + replicaSize <= budget);
+	if ((env.numaPolicy == Environment::NumaReplicate()) && !isReplicaFit) {
+		Log(LogSwitch::Preprocess) << "the replicas of G and sortedG take " << replicaSize / (1024 * 1024)
+			<< "MB beyond the budget of " << env.memoryMb << "MB, interleave them instead." << endl;
+	}
+	if ((env.numaPolicy == Environment::NumaInterleave()) || !isReplicaFit) {
+		Numa::interleave(aux.G.begin(), sizeof(Length) * aux.G.size());
+		Numa::interleave(aux.sortedG.begin(), sizeof(Length) * aux.sortedG.size());
+		Log(LogSwitch::Preprocess) << "interleave G and sortedG over " << nodeNum << " numa nodes." << endl;
+		return;
+	}
+
+	auto replicate = [](LargeArr2D<Length> &replica, const LargeArr2D<Length> &mat, int node) {
+		replica.init(mat.size1(), mat.size2());
+		// set the policy before the first touch so that the pages are allocated on the node.
+		Numa::bind(replica.begin(), sizeof(Length) * replica.size(), node);
+		copy(mat.begin(), mat.end(), replica.begin());
+	};
+	Numa::bind(aux.G.begin(), sizeof(Length) * aux.G.size(), 0);
+	Numa::bind(aux.sortedG.begin(), sizeof(Length) * aux.sortedG.size(), 0);
+	aux.gReplicas.resize(nodeNum - 1);
+	aux.sortedGReplicas.resize(nodeNum - 1);
+	for (int node = 1; node < nodeNum; ++node) {
+		replicate(aux.gReplicas[node - 1], aux.G, node);
+		replicate(aux.sortedGReplicas[node - 1], aux.sortedG, node);
+	}
+	Log(LogSwitch::Preprocess) << "replicate G and sortedG on " << nodeNum << " numa nodes." << endl;
+}
+
+void Solver::planAffinity() {
+	List<int> allowed(System::allowedCpus());
+	if ((env.affinity != Environment::CompactAffinity()) && (env.affinity != Environment::ScatterAffinity())) {
+		for (int cpu : System::parseIdList(env.affinity)) {
+			if (find(allowed.begin(), allowed.end(), cpu) != allowed.end()) { aux.workerCpus.push_back(cpu); }
+		}
+		Log(LogSwitch::Preprocess) << "pin workers to " << aux.workerCpus.size() << " of the given cpus." << endl;
+		return;
+	}
+
+	// (node, core, cpu) where the core is identified by its first hyperthread.
+	List<tuple<int, int, int>> cpus;
+	for (int cpu : allowed) {
+		List<int> siblings(System::threadSiblings(cpu));
+		cpus.emplace_back(Numa::nodeOfCpu(cpu), *min_element(siblings.begin(), siblings.end()), cpu);
+	}
+	sort(cpus.begin(), cpus.end());
+	if (env.affinity == Environment::ScatterAffinity()) {
+		// deal the k_th hyperthread of the cores on each node round robin before the (k+1)_th ones.
+		List<tuple<int, int, int, int>> ranks; // (hyperthread rank, core rank on node, node, cpu).
+		int lastNode = -1, lastCore = -1, coreRank = -1, threadRank = 0;
+		for (auto c = cpus.begin(); c != cpus.end(); ++c) {
+			if (get<0>(*c) != lastNode) { coreRank = -1; lastCore = -1; }
+			if (get<1>(*c) != lastCore) { ++coreRank; threadRank = 0; } else { ++threadRank; }
+			lastNode = get<0>(*c);
+			lastCore = get<1>(*c);
+			ranks.emplace_back(threadRank, coreRank, lastNode, get<2>(*c));
+		}
+		sort(ranks.begin(), ranks.end());
+		for (auto r = ranks.begin(); r != ranks.end(); ++r) { aux.workerCpus.push_back(get<3>(*r)); }
+	} else {
+		for (auto c = cpus.begin(); c != cpus.end(); ++c) { aux.workerCpus.push_back(get<2>(*c)); }
+	}
+	Log(LogSwitch::Preprocess) << "pin workers to " << aux.workerCpus.size() << " cpus by " << env.affinity << "." << endl;
+}
+
+void Solver::pinWorker(ID workerId) {
+	numaNode = 0;
+	if (!aux.workerCpus.empty()) {
+		int cpu = aux.workerCpus[workerId % aux.workerCpus.size()];
+		if (!System::pinThread(List<int>(1, cpu))) {
+			Log(LogSwitch::Szx::Framework) << "fail to pin worker " << workerId << " to cpu " << cpu << "." << endl;
+			return;
+		}
+		// read the replica on the node of the cpu.
+		ID node = Numa::nodeOfCpu(cpu);
+		if (node <= static_cast<ID>(aux.gReplicas.size())) { numaNode = node; }
+		return;
+	}
+	if (aux.gReplicas.empty()) { return; }
+
+	ID node = workerId % static_cast<ID>(aux.gReplicas.size() + 1);
+	if (Numa::pinThread(node)) {
+		numaNode = node;
+	} else {
+		Log(LogSwitch::Szx::Framework) << "fail to pin worker " << workerId << " to numa node " << node << "." << endl;
+	}
+}
+
+void Solver::renumberNodes() {
+	List<ID> newIdOf(Problem::isTopologicalGraph(input)
+		? NodeOrder::reverseCuthillMcKee(input.graph())
+		: NodeOrder::hilbert(input.graph()));
+	NodeOrder::renumber(*input.mutable_graph(), newIdOf);
+	aux.oldIdOf = NodeOrder::inverse(newIdOf);
+	Log(LogSwitch::Preprocess) << "renumber the nodes by "
+		<< (Problem::isTopologicalGraph(input) ? "reverse Cuthill-McKee" : "Hilbert curve") << " order." << endl;
+}
+
+void Solver::allocateMatrix(LargeArr2D<Length> &mat, MappedFile &file, const String &name) {
+	if (env.oocDir.empty()) {
+		mat.init(aux.nodeNum, aux.nodeNum);
+		return;
+	}
+
+	System::makeSureDirExist(env.oocDir);
+	size_t size = sizeof(Length) * static_cast<size_t>(aux.nodeNum) * aux.nodeNum;
+	String path(env.oocDir + env.friendlyInstName() + "." + name + "." + env.localTime + "." + to_string(env.randSeed));
+	if (file.create(path, size, true)) {
+		file.advise(MappedFile::Advice::Sequential); // the matrices are filled row by row.
+		mat.attach(aux.nodeNum, aux.nodeNum, reinterpret_cast<Length*>(file.data()));
+	} else {
+		Log(LogSwitch::Preprocess) << "fail to map " << path << ", fall back to main memory." << endl;
+		mat.init(aux.nodeNum, aux.nodeNum);
+	}
+}
+
+ID Solver::rowCacheSlotNum() const {
+	size_t rowSize = sizeof(Length) * static_cast<size_t>(aux.nodeNum);
+	size_t cacheSize = (aux.rowCacheSize > 0) ? aux.rowCacheSize : (static_cast<size_t>(env.rowCacheMb) * 1024 * 1024);
+	ID slotNum = static_cast<ID>((min)(cacheSize / rowSize, static_cast<size_t>(aux.nodeNum)));
+	// the rows of all centers, the added candidate and the scanned vertex are used at the same time.
+	return (max)(slotNum, static_cast<ID>(aux.centerNum + 2));
+}
+
+void Solver::initPackedDistances() {
+	aux.packedG.init(aux.nodeNum);
+	fill(aux.packedG.begin(), aux.packedG.end(), Problem::MaxDistance);
+	for (ID n = 0; n < aux.nodeNum; ++n) { aux.packedG.at(n, n) = 0; }
+
+	if (Problem::isTopologicalGraph(input)) {
+		for (auto e = input.graph().edges().begin(); e != input.graph().edges().end(); ++e) {
+			// only record the last appearance of each edge.
+			aux.packedG.at(e->source(), e->target()) = e->length();
+		}
+		Timer timer(30s);
+		Floyd::findAllPairsPaths_symmetric(aux.packedG);
+		Log(LogSwitch::Preprocess) << "Floyd takes " << timer.elapsedSeconds() << " seconds." << endl;
+	} else { // geometrical graph.
+		for (ID n = 0; n < aux.nodeNum; ++n) {
+			double nx = input.graph().nodes(n).x();
+			double ny = input.graph().nodes(n).y();
+			Length *row = aux.packedG.lowerRow(n);
+			for (ID m = 0; m < n; ++m) {
+				row[m] = lround(aux.objScale * hypot(nx - input.graph().nodes(m).x(), ny - input.graph().nodes(m).y()));
+			}
+		}
+	}
+
+	ID slotNum = rowCacheSlotNum();
+	aux.rowCache.init(aux.nodeNum, aux.nodeNum, slotNum, [this](ID src, Length *row) { aux.packedG.copyRow(src, row); });
+	Log(LogSwitch::Preprocess) << "expand " << slotNum << " rows of the packed distances on demand." << endl;
+}
+
+void Solver::initLazyDistances() {
+	ID slotNum = rowCacheSlotNum();
+	if (Problem::isTopologicalGraph(input)) {
+		Map<pair<ID, ID>, Length> edges; // only record the last appearance of each edge.
+		for (auto e = input.graph().edges().begin(); e != input.graph().edges().end(); ++e) {
+			edges[{ (min)(e->source(), e->target()), (max)(e->source(), e->target()) }] = e->length();
+		}
+		Length maxWeight = 1; // upper bound of the longest path.
+		aux.adjList.assign(aux.nodeNum, Dijkstra<ID, Length>::AdjVec());
+		for (auto e = edges.begin(); e != edges.end(); ++e) {
+			aux.adjList[e->first.first].push_back(Dijkstra<ID, Length>::AdjNode(e->first.second, e->second));
+			aux.adjList[e->first.second].push_back(Dijkstra<ID, Length>::AdjNode(e->first.first, e->second));
+			maxWeight += e->second;
+		}
+		aux.dijkstra.reset(new Dijkstra<ID, Length>(aux.adjList, 0, maxWeight));
+		aux.rowCache.init(aux.nodeNum, aux.nodeNum, slotNum, [this](ID src, Length *row) {
+			aux.dijkstra->reset(src);
+			aux.dijkstra->findSingleSourcePaths();
+			for (ID n = 0; n < aux.nodeNum; ++n) {
+				Length dist = aux.dijkstra->getDist(n);
+				row[n] = (dist < Dijkstra<ID, Length>::NoLinkWeight) ? dist : Problem::MaxDistance;
+			}
+		});
+	} else { // geometrical graph.
+		aux.rowCache.init(aux.nodeNum, aux.nodeNum, slotNum, [this](ID src, Length *row) {
+			double sx = input.graph().nodes(src).x();
+			double sy = input.graph().nodes(src).y();
+			for (ID n = 0; n < aux.nodeNum; ++n) {
+				row[n] = lround(aux.objScale * hypot(sx - input.graph().nodes(n).x(), sy - input.graph().nodes(n).y()));
+			}
+			row[src] = 0;
+		});
+	}
+	Log(LogSwitch::Preprocess) << "cache " << slotNum << " distance rows on demand." << endl;
+}
+
+void Solver::fillDistRow(ID src, Length *row) {
+	if (aux.voronoi.isEnabled()) {
+		fill(row, row + aux.nodeNum, Problem::MaxDistance);
+		aux.voronoi.forEachNodeWithin(src, Problem::MaxDistance, [&](ID n, Length dist) { row[n] = dist; });
+	} else {
+		const Length *r = distRow(src);
+		copy(r, r + aux.nodeNum, row);
+	}
+}
+
+void Solver::initLandmarks() {
+	// the rounding error of each distance on geometrical graphs is less than 0.5.
+	Length slack = Problem::isTopologicalGraph(input) ? 0 : 1;
+	aux.landmark.init(cfg.landmarkNum, aux.nodeNum, rand.pick(aux.nodeNum), slack, [this](ID src, Length *row) { fillDistRow(src, row); });
+	Log(LogSwitch::Preprocess) << "bound the distances with " << aux.landmark.getLandmarks().size() << " landmarks." << endl;
+}
+
+void Solver::computeLowerBound() {
+	Timer boundTimer(timer.restMilliseconds() / LowerBoundTimeRatio);
+	auto isTimeOut = [&]() { return boundTimer.isTimeOut(); };
+	if (aux.G.empty()) { // the packing tests scan all rows for each radius, which is too slow on the fly.
+		aux.lowerBound = RadiusBound::nearestNeighborBound(aux.nodeNum, aux.centerNum,
+			[this](ID src, Length *row) { fillDistRow(src, row); }, isTimeOut);
+		Log(LogSwitch::Preprocess) << "only bound the radius by the nearest neighbors without G. set target in the cfg to stop earlier." << endl;
+	} else {
+		aux.lowerBound = RadiusBound::lowerBound(aux.G, aux.centerNum, isTimeOut);
+	}
+	Log(LogSwitch::Preprocess) << "the radius is no less than " << aux.lowerBound
+		<< " (" << boundTimer.elapsedSeconds() << " seconds)." << endl;
+}
+
+Length Solver::swapLowerBound(ID c) const {
+	// each critical node is served by either c or its current server after the swap.
+	Length lb = 0;
+	for (auto v = aux.criticals.begin(); v != aux.criticals.end(); ++v) {
+		lb = (max)(lb, (min)(aux.scCur, aux.landmark.lowerBound(c, *v)));
+		if (lb >= aux.scCur) { break; }
+	}
+	return lb;
+}
+
+void Solver::truncateNeighbors() {
+	// the farthest first traversal is a 2-approximation, so the servers are usually within its radius.
+	List<Length> minDist(aux.nodeNum, Problem::MaxDistance);
+	ID next = 0;
+	aux.nearRadius = 0;
+	for (ID c = 0; c < aux.centerNum; ++c) {
+		const Length *row = aux.G[next];
+		aux.nearRadius = 0;
+		for (ID v = 0; v < aux.nodeNum; ++v) {
+			if (row[v] < minDist[v]) { minDist[v] = row[v]; }
+			if (minDist[v] > aux.nearRadius) {
+				aux.nearRadius = minDist[v];
+				next = v;
+			}
+		}
+	}
+
+	// the lists are cut evenly if they exceed the budget.
+	size_t maxLen = (aux.nearBudget > 0) ? (max)(aux.nearBudget / aux.nodeNum, static_cast<size_t>(1)) : aux.nodeNum;
+	aux.nearBegin.assign(aux.nodeNum + 1, 0);
+	aux.nearNodes.clear();
+	for (ID i = 0; i < aux.nodeNum; ++i) {
+		aux.dv.clear();
+		for (ID j = 0; j < aux.nodeNum; ++j) {
+			if (aux.G.at(i, j) <= aux.nearRadius) { aux.dv.push_back({ aux.G.at(i, j), j }); }
+		}
+		sort(aux.dv.begin(), aux.dv.end());
+		if (aux.dv.size() > maxLen) { aux.dv.resize(maxLen); }
+		for (auto n = aux.dv.begin(); n != aux.dv.end(); ++n) { aux.nearNodes.push_back(n->second); }
+		aux.nearBegin[i + 1] = aux.nearNodes.size();
+	}
+	Log(LogSwitch::Preprocess) << "keep " << aux.nearNodes.size() << " sorted neighbors within " << aux.nearRadius << "." << endl;
+}
+
+int Solver::tabuUntil(ID c, ID f) const {
+	if (!aux.T.empty()) { return aux.T.at(c, f); }
+	auto t = aux.sparseT.find(static_cast<long long>((min)(c, f)) * aux.nodeNum + (max)(c, f));
+	return (t == aux.sparseT.end()) ? 0 : t->second;
+}
+
+void Solver::setTabu(ID c, ID f, int until) {
+	if (!aux.T.empty()) {
+		aux.T.at(c, f) = aux.T.at(f, c) = until;
+		return;
+	}
+	if (aux.sparseT.size() > 2 * static_cast<size_t>(aux.tt)) { // drop the expired moves.
+		int step = until - aux.tt;
+		for (auto t = aux.sparseT.begin(); t != aux.sparseT.end();) {
+			t = (t->second <= step) ? aux.sparseT.erase(t) : next(t);
+		}
+	}
+	aux.sparseT[static_cast<long long>((min)(c, f)) * aux.nodeNum + (max)(c, f)] = until;
+}
+
+void Solver::computeDistances(bool truncated) {
+	allocateMatrix(aux.G, aux.gFile, "G");
 	fill(aux.G.begin(), aux.G.end(), Problem::MaxDistance);
 	for (ID n = 0; n < aux.nodeNum; ++n) { aux.G.at(n, n) = 0; }
 
 	if (Problem::isTopologicalGraph(input)) {
-		aux.objScale = Problem::TopologicalGraphObjScale;
 		for (auto e = input.graph().edges().begin(); e != input.graph().edges().end(); ++e) {
 			// only record the last appearance of each edge.
 			aux.G.at(e->source(), e->target()) = e->length();
@@ -425,7 +1167,6 @@ void Solver::init() {
 		Log(LogSwitch::Preprocess) << "Floyd takes " << timer.elapsedSeconds() << " seconds." << endl;
 	}
 	else { // geometrical graph.
-		aux.objScale = Problem::GeometricalGraphObjScale;
 		for (ID n = 0; n < aux.nodeNum; ++n) {
 			double nx = input.graph().nodes(n).x();
 			double ny = input.graph().nodes(n).y();
@@ -436,7 +1177,11 @@ void Solver::init() {
 			}
 		}
 	}
-	aux.sortedG.init(aux.nodeNum, aux.nodeNum);
+	if (truncated) {
+		truncateNeighbors();
+		return;
+	}
+	allocateMatrix(aux.sortedG, aux.sortedGFile, "sortedG");
 	for (ID i = 0; i < aux.nodeNum; ++i) {
 		aux.dv.clear();
 		for (ID j = 0; j < aux.nodeNum; ++j) {
@@ -447,55 +1192,306 @@ void Solver::init() {
 			aux.sortedG.at(i, k) = aux.dv[k].second;
 		}
 	}
+}
+
+void Solver::attachSharedGraph() {
+	DistanceCache::Hash graphHash = DistanceCache::hash(input.graph());
+	SharedGraph::Scope scope = (env.shareGraph == Environment::ShareAcrossProcess())
+		? SharedGraph::Scope::CrossProcess
+		: SharedGraph::Scope::InProcess;
+	aux.sharedGraph = SharedGraph::attach(graphHash, aux.nodeNum, scope,
+		[this](LargeArr2D<Length> &adjMat, LargeArr2D<Length> &sortedAdjList) {
+		// build in the given storage (allocated by computeDistances() if it is empty) and hand it over.
+		aux.G = move(adjMat);
+		aux.sortedG = move(sortedAdjList);
+		computeDistances();
+		adjMat = move(aux.G);
+		sortedAdjList = move(aux.sortedG);
+	});
+
+	// the search never writes G or sortedG.
+	aux.G.attach(aux.nodeNum, aux.nodeNum, const_cast<Length*>(aux.sharedGraph->adjMat().begin()));
+	aux.sortedG.attach(aux.nodeNum, aux.nodeNum, const_cast<Length*>(aux.sharedGraph->sortedAdjList().begin()));
+	Log(LogSwitch::Preprocess) << "share distances of graph " << hex << graphHash << dec
+		<< (aux.sharedGraph->isCrossProcess() ? " across processes." : " in process.") << endl;
+}
+
+bool Solver::loadWarmStart() {
+	Problem::Output sln;
+	pb::Submission submission;
+	if (!sln.load(env.warmStartPath, submission)) {
+		Log(LogSwitch::Preprocess) << "fail to open " << env.warmStartPath << ", start randomly." << endl;
+		return false;
+	}
+
+	// the node number of the input is unchanged by the renumbering.
+	List<bool> isCenter(aux.nodeNum, false);
+	for (auto c = sln.centers().begin(); c != sln.centers().end(); ++c) {
+		if ((*c < 0) || (*c >= aux.nodeNum) || isCenter[*c]) {
+			Log(LogSwitch::Preprocess) << "invalid or duplicated center " << *c << " in " << env.warmStartPath << ", start randomly." << endl;
+			return false;
+		}
+		isCenter[*c] = true;
+	}
+	if (sln.centers().empty()) { return false; }
+	if (submission.instance() != env.friendlyInstName()) {
+		Log(LogSwitch::Preprocess) << "warm start from the solution of " << submission.instance() << "." << endl;
+	}
+	if (sln.centers().size() != aux.centerNum) { // initialSol() adds or drops the centers.
+		Log(LogSwitch::Preprocess) << "adjust " << sln.centers().size() << " warm start centers to " << aux.centerNum << "." << endl;
+	}
+	aux.seedCenters.assign(sln.centers().begin(), sln.centers().end());
+	return true;
+}
+
+bool Solver::loadCheckpoint() {
+	Checkpoint &ckpt(aux.resume);
+	if (!ckpt.load(env.resumePath)) {
+		Log(LogSwitch::Preprocess) << "fail to load the checkpoint " << env.resumePath << ", start afresh." << endl;
+		return false;
+	}
+	auto isValidId = [&](ID n) { return (n >= 0) && (n < aux.nodeNum); };
+	bool isValid = (ckpt.graphHash == aux.graphHash) && (ckpt.nodeNum == aux.nodeNum) && (ckpt.centerNum == aux.centerNum)
+		&& (static_cast<ID>(ckpt.centers.size()) == aux.centerNum) && (static_cast<ID>(ckpt.bestCenters.size()) == aux.centerNum)
+		&& all_of(ckpt.centers.begin(), ckpt.centers.end(), isValidId)
+		&& all_of(ckpt.bestCenters.begin(), ckpt.bestCenters.end(), isValidId)
+		&& all_of(ckpt.tabu.begin(), ckpt.tabu.end(), [&](const Checkpoint::TabuMove &t) { return isValidId(t.c) && isValidId(t.f); });
+	if (!isValid) {
+		Log(LogSwitch::Preprocess) << "the checkpoint " << env.resumePath << " belongs to another graph or p, start afresh." << endl;
+		return false;
+	}
+	return true;
+}
+
+int Solver::restoreCheckpoint() {
+	const Checkpoint &ckpt(aux.resume);
+	resetCenters(ckpt.centers);
+	aux.bestS = Set<ID>(ckpt.bestCenters.begin(), ckpt.bestCenters.end());
+	aux.scBest = ckpt.bestRadius;
+	aux.tt = ckpt.tabuTenure;
+	for (auto t = ckpt.tabu.begin(); t != ckpt.tabu.end(); ++t) { setTabu(t->c, t->f, t->until); }
+	istringstream iss(ckpt.rngState);
+	iss >> rand.rgen;
+	return ckpt.iteration;
+}
+
+void Solver::saveCheckpoint(int iteration) {
+	shared_ptr<Checkpoint> ckpt(make_shared<Checkpoint>());
+	ckpt->graphHash = aux.graphHash;
+	ckpt->nodeNum = aux.nodeNum;
+	ckpt->centerNum = aux.centerNum;
+	ckpt->iteration = iteration;
+	ckpt->tabuTenure = aux.tt;
+	ckpt->bestRadius = aux.scBest;
+	ostringstream oss;
+	oss << rand.rgen;
+	ckpt->rngState = oss.str();
+	ckpt->centers.assign(aux.S.begin(), aux.S.end());
+	ckpt->bestCenters.assign(aux.bestS.begin(), aux.bestS.end());
+	if (!aux.T.empty()) {
+		for (ID c = 0; c < aux.nodeNum; ++c) {
+			for (ID f = c + 1; f < aux.nodeNum; ++f) {
+				if (aux.T.at(c, f) > iteration) { ckpt->tabu.push_back({ c, f, aux.T.at(c, f) }); }
+			}
+		}
+	} else {
+		for (auto t = aux.sparseT.begin(); t != aux.sparseT.end(); ++t) {
+			if (t->second <= iteration) { continue; }
+			ckpt->tabu.push_back({ static_cast<ID>(t->first / aux.nodeNum), static_cast<ID>(t->first % aux.nodeNum), t->second });
+		}
+	}
+	aux.writer->post(env.checkpointPath, [ckpt](const String &path) { return ckpt->save(path); });
+}
+
+void Solver::streamSolution() {
+	lock_guard<mutex> streamGuard(aux.streamMutex);
+	if (aux.scBest >= aux.streamedRadius) { return; }
+	aux.streamedRadius = aux.scBest;
+
+	Solution sln(this);
+	for (const auto &s : aux.bestS) { sln.add_centers(aux.oldIdOf.empty() ? s : aux.oldIdOf[s]); }
+	sln.coverRadius = aux.scBest;
+	String thread(to_string(env.jobNum));
+	String instance(env.friendlyInstName());
+	String duration(to_string(timer.elapsedSeconds()) + "s");
+	aux.writer->post(env.slnPath, [sln, thread, instance, duration](const String &path) {
+		pb::Submission submission;
+		submission.set_thread(thread);
+		submission.set_instance(instance);
+		submission.set_duration(duration);
+		return sln.save(path, submission);
+	});
+}
+
+void Solver::init() {
+	if (env.renumber) { renumberNodes(); }
+
+	aux.nodeNum = input.graph().nodenum();
+	aux.centerNum = input.centernum();
+	aux.tt = static_cast<Length>(cfg.tenureNodeCoef * aux.nodeNum)
+		+ rand.pick((max)(1, static_cast<int>(cfg.tenureCenterCoef * aux.centerNum)));
+	aux.objScale = Problem::isTopologicalGraph(input)
+		? Problem::TopologicalGraphObjScale
+		: Problem::GeometricalGraphObjScale;
+
+	planLayout();
+
+	bool isVoronoi = (env.layout == Environment::VoronoiLayout());
+	if (isVoronoi && !Problem::isTopologicalGraph(input)) {
+		Log(LogSwitch::Preprocess) << "the voronoi layout needs a topological graph, fall back to all pairs." << endl;
+		isVoronoi = false;
+	}
+
+	if (isVoronoi) {
+		aux.voronoi.init(input.graph(), aux.D, aux.F);
+		Log(LogSwitch::Preprocess) << "maintain the voronoi cells with " << aux.voronoi.memoryUsage() << " bytes." << endl;
+	} else if (env.layout == Environment::PackedLayout()) {
+		initPackedDistances();
+	} else if (env.layout == Environment::TruncatedLayout()) {
+		computeDistances(true);
+	} else if ((env.layout == Environment::LazyLayout()) || (env.rowCacheMb > 0)) {
+		initLazyDistances();
+	} else if (!env.shareGraph.empty() && env.oocDir.empty()) {
+		attachSharedGraph();
+	} else if (env.cacheDir.empty()) {
+		computeDistances();
+	} else {
+		DistanceCache::Hash graphHash = DistanceCache::hash(input.graph());
+		if (aux.distCache.load(env.cacheDir, graphHash, aux.nodeNum, aux.G, aux.sortedG)) {
+			Log(LogSwitch::Preprocess) << "load distances from " << DistanceCache::path(env.cacheDir, graphHash) << endl;
+		} else {
+			computeDistances();
+			DistanceCache::save(env.cacheDir, graphHash, aux.G, aux.sortedG);
+		}
+	}
+	aux.isGMapped = aux.distCache.isLoaded() || aux.gFile.isOpen();
+	if (aux.isGMapped) { // rows of G are scanned entirely while only a prefix of the sorted rows is read.
+		MappedFile::advise(aux.G.begin(), sizeof(Length) * aux.G.size(), MappedFile::Advice::Normal);
+		MappedFile::advise(aux.sortedG.begin(), sizeof(Length) * aux.sortedG.size(), MappedFile::Advice::Random);
+	}
+	if (!env.numaPolicy.empty()) { placeOnNuma(); }
 
 	aux.F.init(2, aux.nodeNum);
 	fill(aux.F.begin(), aux.F.end(), aux.nodeNum);
 	aux.D.init(2, aux.nodeNum);
 	fill(aux.D.begin(), aux.D.end(), Problem::MaxDistance);
-	aux.T.init(aux.nodeNum, aux.nodeNum);
-	fill(aux.T.begin(), aux.T.end(), 0);
+	if (!aux.rowCache.isEnabled() && !aux.voronoi.isEnabled()) { // use sparseT instead on huge instances.
+		allocateMatrix(aux.T, aux.tFile, "T");
+		if (aux.tFile.isOpen()) { // the file is zero-filled on creation.
+			aux.tFile.advise(MappedFile::Advice::Random);
+		} else {
+			fill(aux.T.begin(), aux.T.end(), 0);
+		}
+	}
+	if ((cfg.landmarkNum > 0) && aux.G.empty()) { initLandmarks(); } // exact distances are expensive.
+
+	if (!env.checkpointPath.empty() || !env.resumePath.empty()) { aux.graphHash = DistanceCache::hash(input.graph()); }
+	if (!env.resumePath.empty()) { aux.isResumed = loadCheckpoint(); }
+	if ((env.streamSolution && !env.slnPath.empty()) || !env.checkpointPath.empty()) { aux.writer.reset(new AsyncWriter()); }
+
+	// the edges are no longer needed once the distances are ready.
+	google::protobuf::RepeatedPtrField<pb::PCenter::Edge>().Swap(input.mutable_graph()->mutable_edges());
+
 	aux.M.init(aux.nodeNum);
 	aux.Nodes.init(aux.nodeNum);
 	for (int k = 0; k < aux.nodeNum; ++k) { aux.Nodes[k] = k; }
 
 	//auto pos = env.instPath.find("pmed");
-	aux.optValue = aux.opt[stoi(env.instPath.substr(9, 2)) - 1];
+	if (!env.warmStartPath.empty() && aux.seedCenters.empty()) { loadWarmStart(); }
+
+	if (cfg.stopAtOptimum) { computeLowerBound(); }
+	aux.optValue = (max)(aux.lowerBound, static_cast<Length>(floor(cfg.targetRadius * aux.objScale)));
 }
 
 bool Solver::optimize(Solution &sln, ID workerId) {
 	//Log(LogSwitch::Szx::Framework) << "worker " << workerId << " starts." << endl;
 
+	pinWorker(workerId);
+
 	// reset solution state.
 	bool status = true;
 	auto &centers(*sln.mutable_centers());
 	centers.Resize(aux.centerNum, Problem::InvalidId);
 
 	// TODO[0]: replace the following random assignment with your own algorithm.
-	initialSol();
 	int iterTime = 0;
-	while (!timer.isTimeOut()) {
+	if (aux.isResumed) {
+		iterTime = aux.resumeIteration; // restored in solve().
+	} else {
+		initialSol(aux.seedCenters);
+		if (!aux.seedCenters.empty()) {
+			Log(LogSwitch::Szx::Framework) << "start from the seed with radius " << aux.scCur << "." << endl;
+		}
+	}
+	reserveSaveTime();
+	bool isStreaming = aux.writer && env.streamSolution && !env.slnPath.empty();
+	if (isStreaming) { streamSolution(); }
+	if ((cfg.alg == Configuration::Algorithm::RadiusDecision) && !aux.isResumed) {
+		if (aux.G.empty() || aux.sortedG.empty()) {
+			Log(LogSwitch::Szx::Framework) << "the radius decision needs G and sortedG, fall back to swaps." << endl;
+		} else if (decideRadius()) {
+			if (isStreaming) { streamSolution(); }
+			Log(LogSwitch::Szx::Framework) << "the radius decision ends with radius " << aux.scBest << "." << endl;
+		}
+	}
+	bool isCheckpointing = aux.writer && !env.checkpointPath.empty() && (workerId == 0); // the workers share aux.
+	Timer checkpointTimer(Timer::toMillisecond(env.checkpointInterval));
+	PerfCounter cacheMiss(PerfCounter::Event::CacheMiss);
+	cacheMiss.start();
+	int startIteration = iterTime; // the iterations before a resume are not done in this run.
+	int lastImprovement = iterTime;
+	Timer::Millisecond lastRest = timer.restMilliseconds();
+	while (!isStopRequested) {
+		Timer::Millisecond rest = timer.restMilliseconds();
+		if (rest <= aux.saveTime + (lastRest - rest)) { break; } // the next iteration may take as long as the last one.
+		lastRest = rest;
 		// ִн
 		aux.m = findPair(iterTime);
 		addFacility(aux.m.first);
 		removeFacility(aux.m.second);
-		aux.T.at(aux.m.first, aux.m.second) = aux.T.at(aux.m.second, aux.m.first) = aux.tt + iterTime;
+		setTabu(aux.m.first, aux.m.second, aux.tt + iterTime);
 		//cout << "Iter : " << iterTime << "add : " << aux.m.first << "\t remove : " << aux.m.second << endl;
 		// ʷֵ
 		if (aux.scCur < aux.scBest) {
 			aux.scBest = aux.scCur;
 			aux.bestS = aux.S;
+			lastImprovement = iterTime;
 			//printf("scBest = %d,\titer = %d\n", aux.scBest, iterTime);
+			if (isStreaming) { streamSolution(); }
 		}
 		// ҵֵ
 		if (aux.scBest <= aux.optValue) break;
 		++iterTime;
+		if (iterTime >= env.maxIter) { break; }
+		if ((cfg.maxStagnation > 0) && (iterTime - lastImprovement > cfg.maxStagnation)) { break; }
+		if (isProgressRequested && isProgressRequested.exchange(false)) { reportProgress(iterTime); }
+		if (isCheckpointing && checkpointTimer.isTimeOut()) {
+			saveCheckpoint(iterTime);
+			checkpointTimer = Timer(Timer::toMillisecond(env.checkpointInterval));
+		}
 	}
+	cacheMiss.stop();
+	if (isCheckpointing) { saveCheckpoint(iterTime); } // extend the run later.
 	ID c = 0;
 	for (const auto &s : aux.bestS) {
-		centers[c++] = s;
+		centers[c++] = aux.oldIdOf.empty() ? s : aux.oldIdOf[s];
 	}
 	//copy(aux.bestS.cbegin(), aux.bestS.cend(), centers);
 	sln.coverRadius = aux.scBest; // record obj.
+	iteration = iterTime;
+	if (aux.rowCache.isEnabled()) {
+		Log(LogSwitch::Szx::Framework) << "row cache hits " << aux.rowCache.getHitCount()
+			<< " misses " << aux.rowCache.getMissCount() << endl;
+	}
+	if (!aux.nearBegin.empty()) {
+		Log(LogSwitch::Szx::Framework) << "scan " << aux.farCandidateNum << " rows for the servers beyond the truncated lists." << endl;
+	}
+	Log(LogSwitch::Szx::Framework) << "cache misses " << cacheMiss.count() << " in "
+		<< (iteration - startIteration) / (max)(timer.elapsedSeconds(), 1e-3) << " iterations per second." << endl;
+	if (aux.landmark.isEnabled()) {
+		Log(LogSwitch::Szx::Framework) << "landmarks prune " << aux.prunedCandidateNum << " of "
+			<< (aux.prunedCandidateNum + aux.evaluatedCandidateNum) << " candidates." << endl;
+	}
 
 	//Log(LogSwitch::Szx::Framework) << "worker " << workerId << " ends." << endl;
 	return status;
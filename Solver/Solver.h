@@ -16,11 +16,27 @@
 #include <sstream>
 #include <thread>
 #include <array>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
 
 #include "Common.h"
 #include "Utility.h"
 #include "LogSwitch.h"
+#include "CsvReader.h"
 #include "Problem.h"
+#include "DistanceCache.h"
+#include "RowCache.h"
+#include "VoronoiEngine.h"
+#include "LandmarkBound.h"
+#include "RadiusBound.h"
+#include "CoverSearch.h"
+#include "NodeOrder.h"
+#include "SharedGraph.h"
+#include "AsyncWriter.h"
+#include "Checkpoint.h"
+#include "../Checker/ShortestPath.h"
 
 
 namespace szx {
@@ -29,6 +45,9 @@ namespace szx {
 class Solver {
     #pragma region Type
 public:
+    struct Configuration;
+    struct Environment;
+
     // commmand line interface.
     struct Cli {
         static constexpr int MaxArgLen = 256;
@@ -44,6 +63,21 @@ public:
         static String EnvironmentPathOption() { return "-env"; }
         static String ConfigPathOption() { return "-cfg"; }
         static String LogPathOption() { return "-log"; }
+        static String CacheDirOption() { return "-cache"; }
+        static String OutOfCoreDirOption() { return "-ooc"; }
+        static String LazyRowOption() { return "-lazy"; }
+        static String DistanceLayoutOption() { return "-layout"; }
+        static String RenumberOption() { return "-renumber"; }
+        static String MemoryBudgetOption() { return "-mem"; }
+        static String NumaOption() { return "-numa"; }
+        static String AffinityOption() { return "-affinity"; }
+        static String ShareGraphOption() { return "-share"; }
+        static String SweepOption() { return "-sweep"; }
+        static String WarmStartOption() { return "-warm"; }
+        static String StreamOption() { return "-stream"; }
+        static String CheckpointOption() { return "-checkpoint"; }
+        static String CheckpointIntervalOption() { return "-interval"; }
+        static String ResumeOption() { return "-resume"; }
 
         static String AuthorNameSwitch() { return "-name"; }
         static String HelpSwitch() { return "-h"; }
@@ -53,7 +87,11 @@ public:
             return "Pattern (args can be in any order):\n"
                 "  exe (-p path) (-o path) [-s int] [-t seconds] [-name]\n"
                 "      [-iter int] [-j int] [-id string] [-h]\n"
-                "      [-env path] [-cfg path] [-log path]\n"
+                "      [-env path] [-cfg path] [-log path] [-cache path] [-ooc path]\n"
+                "      [-lazy int] [-layout name] [-renumber int] [-mem int]\n"
+                "      [-numa policy] [-affinity policy] [-share scope] [-sweep list]\n"
+                "      [-warm path] [-stream int] [-checkpoint path] [-interval seconds]\n"
+                "      [-resume path]\n"
                 "Switches:\n"
                 "  -name  return the identifier of the authors.\n"
                 "  -h     print help information.\n"
@@ -68,6 +106,45 @@ public:
                 "  -env   environment file path.\n"
                 "  -cfg   configuration file path.\n"
                 "  -log   activate logging and specify log file path.\n"
+                "  -cache reuse the preprocessed distances in the directory.\n"
+                "  -ooc   keep the n*n matrices in temporary files in the directory\n"
+                "         instead of the main memory for huge instances.\n"
+                "  -lazy  compute the distance rows on demand and cache at most the\n"
+                "         given megabytes of them instead of all pairs.\n"
+                "  -layout how the distances are kept. \"voronoi\" maintains the 2\n"
+                "         nearest centers on the edges of topological graphs only.\n"
+                "         \"packed\" stores half of the symmetric matrix and expands\n"
+                "         the rows in use into the row cache given by -lazy.\n"
+                "         \"truncated\" only sorts the neighbors within an upper\n"
+                "         bound of the optimal radius. \"lazy\" is the same as -lazy.\n"
+                "  -renumber reorder the nodes by locality before preprocessing if\n"
+                "         non-zero. the output still uses the original ids.\n"
+                "  -mem   pick the fastest layout whose estimated footprint fits in\n"
+                "         the given megabytes. it overrides -layout and -lazy.\n"
+                "  -numa  \"replicate\" copies G and sortedG to each numa node and pins\n"
+                "         the workers to the nodes round robin. \"interleave\" spreads\n"
+                "         their pages over all nodes. the copies count against -mem\n"
+                "         and it interleaves instead if they do not fit.\n"
+                "  -affinity pin the workers to the allowed cpus. \"compact\" fills\n"
+                "         the hyperthreads of a core and the cores of a numa node\n"
+                "         first. \"scatter\" spreads them over the nodes and cores.\n"
+                "         a cpu list like \"0,2,4-7\" pins the workers round robin.\n"
+                "  -share reuse G and sortedG built by the other solvers of the same\n"
+                "         graph. \"process\" shares them in this process and \"shm\"\n"
+                "         also across processes through the shared memory.\n"
+                "  -sweep solve the graph for each center number in the list like\n"
+                "         \"10,20,50-52\" instead of the one in the instance. the\n"
+                "         distances are preprocessed once. the solution of p is saved\n"
+                "         to the output path with \".p<p>\" before its extension. each\n"
+                "         run starts from the solution of the nearest finished p.\n"
+                "         the checkpoint and resume paths are suffixed likewise.\n"
+                "  -warm  start the search from the centers in the solution file\n"
+                "         instead of a random solution.\n"
+                "  -stream save each improving solution to the output path in the\n"
+                "         background if non-zero (default).\n"
+                "  -checkpoint save the state of the search to the path periodically.\n"
+                "  -interval seconds between 2 checkpoints.\n"
+                "  -resume continue the search from the checkpoint file.\n"
                 "Note:\n"
                 "  0. in pattern, () is non-optional group, [] is optional group\n"
                 "     when -env option is not given.\n"
@@ -83,11 +160,18 @@ public:
 
         // a dummy main function.
         static int run(int argc, char *argv[]);
+        // SIGTERM and SIGINT stop the search with the best solution, SIGUSR1 prints the progress to stderr.
+        static void handleSignals();
+        // solve the instance for each center number in env.sweep and save each solution.
+        // at most env.jobNum of them run at the same time.
+        static int sweep(const Problem::Input &input, const Environment &env, const Configuration &cfg);
     };
 
     // controls the I/O data format, exported contents and general usage of the solver.
     struct Configuration {
-        enum Algorithm { Greedy, TreeSearch, DynamicProgramming, LocalSearch, Genetic, MathematicallProgramming };
+        // RadiusDecision searches the radius by deciding whether p centers cover all nodes within it
+        // before the swap based tabu search.
+        enum Algorithm { Greedy, TreeSearch, DynamicProgramming, LocalSearch, Genetic, MathematicallProgramming, RadiusDecision };
 
 
         Configuration() {}
@@ -100,13 +184,33 @@ public:
             String threadNum(std::to_string(threadNumPerWorker));
             std::ostringstream oss;
             oss << "alg=" << alg
-                << ";job=" << threadNum;
+                << ";job=" << threadNum
+                << ";lm=" << landmarkNum
+                << ";ttn=" << tenureNodeCoef
+                << ";ttp=" << tenureCenterCoef
+                << ";stag=" << maxStagnation
+                << ";opt=" << stopAtOptimum
+                << ";target=" << targetRadius
+                << ";cstag=" << coverStagnation;
             return oss.str();
         }
 
 
         Algorithm alg = Configuration::Algorithm::Greedy; // OPTIMIZE[szx][3]: make it a list to specify a series of algorithms to be used by each threads in sequence.
         int threadNumPerWorker = (std::min)(1, static_cast<int>(std::thread::hardware_concurrency()));
+        int landmarkNum = 16; // number of landmarks for bounding the distances when G is not precomputed.
+
+        // the tabu tenure is tenureNodeCoef * nodeNum + rand[0, tenureCenterCoef * centerNum).
+        double tenureNodeCoef = 2;
+        double tenureCenterCoef = 1;
+
+        // stopping rules besides the timeout and the max iteration.
+        int maxStagnation = 0; // stop after this many iterations without improvement if positive.
+        bool stopAtOptimum = true; // stop once the radius reaches the lower bound proven in preprocessing.
+        double targetRadius = 0; // stop once the radius (in the unit of the instance) is no greater than it.
+
+        // give up covering at a radius in the radius decision after this many steps without covering more nodes.
+        int coverStagnation = 20000;
     };
 
     // describe the requirements to the input and output data interface.
@@ -114,8 +218,11 @@ public:
         static constexpr int DefaultTimeout = (1 << 30);
         static constexpr int DefaultMaxIter = (1 << 30);
         static constexpr int DefaultJobNum = 0;
-        // preserved time for IO in the total given time.
-        static constexpr int SaveSolutionTimeInMillisecond = 1000;
+        // preserved time for IO in the total given time is the measured serialization cost
+        // of the solution times the factor plus the margin for the file system.
+        static constexpr int SaveSolutionMarginInMillisecond = 50;
+        static constexpr int SaveSolutionCostFactor = 4; // a streamed write in flight, the output and its timestamped copy.
+        static constexpr double DefaultCheckpointInterval = 60;
 
         static constexpr Duration RapidModeTimeoutThreshold = 600 * static_cast<Duration>(Timer::MillisecondsPerSecond);
 
@@ -125,6 +232,22 @@ public:
         static String DefaultEnvPath() { return "env.csv"; }
         static String DefaultCfgPath() { return "cfg.csv"; }
         static String DefaultLogPath() { return "log.csv"; }
+        static String DefaultCacheDir() { return "Cache/"; }
+        static String DefaultOutOfCoreDir() { return "OutOfCore/"; }
+
+        static String VoronoiLayout() { return "voronoi"; }
+        static String PackedLayout() { return "packed"; }
+        static String TruncatedLayout() { return "truncated"; }
+        static String LazyLayout() { return "lazy"; }
+
+        static String NumaReplicate() { return "replicate"; }
+        static String NumaInterleave() { return "interleave"; }
+
+        static String CompactAffinity() { return "compact"; }
+        static String ScatterAffinity() { return "scatter"; }
+
+        static String ShareInProcess() { return "process"; }
+        static String ShareAcrossProcess() { return "shm"; }
 
         Environment(const String &instancePath, const String &solutionPath,
             int randomSeed = Random::generateSeed(), double timeoutInSecond = DefaultTimeout,
@@ -140,9 +263,17 @@ public:
         void loadWithoutCalibrate(const String &filePath);
         void save(const String &filePath) const;
 
-        void calibrate(); // adjust job number and timeout to fit the platform.
+        void calibrate(); // adjust job number to fit the platform.
 
         String solutionPathWithTime() const { return slnPath + "." + localTime; }
+        String solutionPathOfSweep(int centerNum) const { return pathOfSweep(slnPath, centerNum); }
+        static String pathOfSweep(const String &path, int centerNum) { // insert the center number before the extension.
+            if (path.empty()) { return path; }
+            auto pos = path.find_last_of('.');
+            bool hasExt = (pos != String::npos) && (path.find('/', pos) == String::npos);
+            String p(".p" + std::to_string(centerNum));
+            return hasExt ? (path.substr(0, pos) + p + path.substr(pos)) : (path + p);
+        }
 
         String visualizPath() const { return DefaultVisualizationDir() + friendlyInstName() + "." + localTime + ".html"; }
         template<typename T>
@@ -168,6 +299,21 @@ public:
         String rid; // the id of each run.
         String cfgPath;
         String logPath;
+        String cacheDir; // directory of the preprocessed distance cache. no cache if it is empty.
+        String oocDir; // directory of the out-of-core matrices. all matrices are on the heap if it is empty.
+        int rowCacheMb = 0; // compute distance rows on demand and cache at most this many megabytes of them if positive.
+        String layout; // the representation of the distances. all pairs distances are precomputed if it is empty.
+        bool renumber = false; // reorder the nodes along a space filling curve or by bandwidth reduction.
+        int memoryMb = 0; // choose the layout and the row cache size under this budget if positive.
+        String numaPolicy; // placement of the read-only matrices on numa machines. first touch if it is empty.
+        String affinity; // the cpus to pin the workers to. the workers float in the process cpu mask if it is empty.
+        String shareGraph; // the scope to share the preprocessed distances in. each solver builds its own if it is empty.
+        String sweep; // the center numbers to solve the graph for. only the one in the instance is solved if it is empty.
+        String warmStartPath; // the solution to start from. start randomly if it is empty.
+        bool streamSolution = true; // save every improving solution to slnPath in the background.
+        String checkpointPath; // the file to save the state of the search to. no checkpoint if it is empty.
+        double checkpointInterval = DefaultCheckpointInterval; // in seconds.
+        String resumePath; // the checkpoint to continue from. start afresh if it is empty.
 
         // auto-generated data.
         String localTime;
@@ -182,6 +328,7 @@ public:
 
     #pragma region Constant
 public:
+    static constexpr int LowerBoundTimeRatio = 10; // spend at most 1/10 of the rest time on the lower bound.
     #pragma endregion Constant
 
     #pragma region Constructor
@@ -195,16 +342,59 @@ public:
 public:
     bool solve(); // return true if exit normally. solve by multiple workers together.
     bool check(Length &obj) const;
+    void reportProgress(int iteration) const; // print the state of the search to stderr.
+    void reserveSaveTime(); // time a dry run of serializing the best solution and stop the search earlier by that.
+    // start from the centers (in the ids of the input) instead of a random solution.
+    void setSeed(const List<ID> &centers) { aux.seedCenters = centers; }
     void record() const; // save running log.
 
 protected:
     void init();
+    void planLayout(); // choose the layout of the distances under the memory budget.
+    void placeOnNuma(); // replicate or interleave G and sortedG.
+    void planAffinity(); // order the allowed cpus for the workers by the affinity policy.
+    void pinWorker(ID workerId); // run the worker on a numa node or a cpu and read the local replica.
+    void renumberNodes(); // permute the ids in input and keep the inverse permutation for the output.
+    void computeDistances(bool truncated = false); // fill G and sortedG (or the truncated neighbor lists) from the input graph.
+    void truncateNeighbors(); // sort the neighbors within the radius of a farthest first solution.
+    void allocateMatrix(LargeArr2D<Length> &mat, MappedFile &file, const String &name);
+    void initLazyDistances(); // prepare single source shortest paths instead of G and sortedG.
+    void initPackedDistances(); // fill the lower triangle of G instead of G and sortedG.
+    void attachSharedGraph(); // read G and sortedG built once for all solvers of the graph.
+    bool loadWarmStart(); // take the centers of a previous solution as the seed.
+    bool loadCheckpoint(); // read and validate the checkpoint to resume from.
+    int restoreCheckpoint(); // rebuild the search state from the checkpoint and return its iteration.
+    void saveCheckpoint(int iteration); // write the state of the search in the background.
+    void streamSolution(); // write the best solution in the background if no worker has streamed a better one.
+    ID rowCacheSlotNum() const;
+    void initLandmarks();
+    void computeLowerBound(); // prove a lower bound of the optimal radius to stop the search early.
+    // lower bound of the objective after adding c and removing any other center.
+    Length swapLowerBound(ID c) const;
+
+    // the copies of G and sortedG on the numa node of the calling worker.
+    const LargeArr2D<Length>& localG() const { return (numaNode > 0) ? aux.gReplicas[numaNode - 1] : aux.G; }
+    const LargeArr2D<Length>& localSortedG() const { return (numaNode > 0) ? aux.sortedGReplicas[numaNode - 1] : aux.sortedG; }
+
+    // the distances from src to all nodes.
+    const Length* distRow(ID src) { return aux.rowCache.isEnabled() ? aux.rowCache.row(src) : localG()[src]; }
+    void fillDistRow(ID src, Length *row); // copy the distances from src in any layout.
+
+    // the iteration until which swapping c and f is forbidden.
+    int tabuUntil(ID c, ID f) const;
+    void setTabu(ID c, ID f, int until);
     bool optimize(Solution &sln, ID workerId = 0); // optimize by a single worker.
 	void addFacility(const int f);
 	void findNext(const int v, const int f);
 	void removeFacility(const int f);
 	void candidate();
-	void initialSol();
+	void initialSol(const List<ID> &seed = List<ID>()); // complete the seed centers greedily or drop the cheapest ones.
+	void resetCenters(const List<ID> &centers); // rebuild the solution state from scratch.
+	// bisect the distinct distances below the best radius by covering with p centers. return false if interrupted.
+	bool decideRadius();
+	// the nodes within the radius of v are the prefix sortedG[v][0, coverNum[v]).
+	void countCoverers(Length radius, List<ID> &coverNum);
+	bool coverGreedily(const List<ID> &coverNum, List<ID> &centers); // return true if all nodes are covered by p centers.
 	MvPair findPair(const int step);
 
     #pragma endregion Method
@@ -217,7 +407,8 @@ public:
     struct { // auxiliary data for solver.
         double objScale;
 
-		Arr2D<Length> G, F, D, T, sortedG;
+		LargeArr2D<Length> G, T, sortedG;
+		Arr2D<Length> F, D;
 		Length nodeNum, edgeNum, centerNum;
 		Length scCur, scBest, tt;
 		Arr<Length> M, Nodes;
@@ -226,17 +417,53 @@ public:
 		List<MvPair> tabuMv, noTabuMv;	// ɶǽɶ
 		List<MvPair> dv;
 		MvPair m; // 
-				  // ݼӦֵ
-		std::array<int, 94> opt = { 127, 98, 93, 74, 48, 84, 64, 55, 37, 20,
-			59, 51, 36, 26, 18, 47, 39, 28, 18, 13, 40, 38, 22, 15, 11,
-			38, 32, 18, 13, 9, 30, 29, 15, 11, 30, 27, 15, 29, 23, 13,
-
-			227308,158080,120777,102056,90492,78117,71076,65216,60788,57001,53884,51028,49965,45246,44701,
-			307730,201640,163150,135236,118727,106301,97193,89506,83200,78970,
-			45791,30901,24099,20946,18491,16265,14811,13680,12954,12701,10925,10778,10775,10161,10160,
-			72854,49304,39350,33642,29820,20663,16477,14090,12278,11525,10481,9751,8896,8500
-		};
-		ID optValue;
+		Length lowerBound = 0; // the proven lower bound of the optimal radius.
+		Length optValue = 0; // stop once the best radius reaches it.
+
+		DistanceCache distCache; // keep the mapped G and sortedG alive.
+		SharedGraph::Ptr sharedGraph; // keep the shared G and sortedG alive.
+		MappedFile gFile, sortedGFile, tFile; // backing files of the out-of-core matrices.
+		bool isGMapped = false; // G is backed by a file (cache or out-of-core).
+
+		RowCache rowCache; // the recently used rows of G when it is not precomputed.
+		size_t rowCacheSize = 0; // the bytes of the row cache planned by -mem. use env.rowCacheMb if it is 0.
+		size_t plannedSize = 0; // the estimated footprint of the layout chosen under -mem.
+		SymArr2D<Length> packedG; // the lower triangle of G.
+
+		// the neighbors of node v within nearRadius sorted by distance are nearNodes[nearBegin[v]..nearBegin[v + 1]).
+		List<size_t> nearBegin;
+		List<ID> nearNodes;
+		Length nearRadius = 0;
+		size_t nearBudget = 0; // the max total length of the truncated lists. no limit if it is 0.
+
+		// G and sortedG on the numa nodes 1, 2, ..., while node 0 keeps the original ones.
+		List<LargeArr2D<Length>> gReplicas;
+		List<LargeArr2D<Length>> sortedGReplicas;
+		List<int> workerCpus; // the i_th worker runs on workerCpus[i % workerCpus.size()] if it is not empty.
+		long long farCandidateNum = 0; // the times that the server is beyond the truncated list.
+		Dijkstra<ID, Length>::AdjList adjList;
+		std::unique_ptr<Dijkstra<ID, Length>> dijkstra;
+		std::unordered_map<long long, int> sparseT; // replace T on huge instances. the key is the pair of nodes.
+
+		VoronoiEngine voronoi; // maintain F and D on the edges instead of G and sortedG.
+
+		LandmarkBound landmark; // skip the candidates which can not beat the best move found.
+		CoverSearch coverSearch; // decide whether p centers cover all nodes within a radius.
+		List<ID> criticals; // the nodes whose distances to their servers equal scCur.
+		List<ID> seedCenters; // the initial centers in the ids of the input. start randomly if it is empty.
+
+		std::unique_ptr<AsyncWriter> writer; // save the solutions and checkpoints without blocking the search.
+		std::mutex streamMutex;
+		Length streamedRadius = Problem::MaxDistance; // the best radius posted to the writer.
+		DistanceCache::Hash graphHash = 0; // identify the graph in the checkpoints.
+		Checkpoint resume;
+		bool isResumed = false;
+		int resumeIteration = 0; // the iteration of the checkpoint restored by solve().
+		Timer::Millisecond saveTime = Timer::toMillisecond(Environment::SaveSolutionMarginInMillisecond / Timer::MillisecondsPerSecond);
+		long long prunedCandidateNum = 0;
+		long long evaluatedCandidateNum = 0;
+
+		List<ID> oldIdOf; // the input id of each renumbered node. empty if the nodes are not renumbered.
     } aux;
 
     Environment env;
@@ -245,6 +472,12 @@ public:
     Random rand; // all random number in Solver must be generated by this.
     Timer timer; // the solve() should return before it is timeout.
     Iteration iteration;
+
+    static thread_local ID numaNode; // the numa node of the calling worker.
+
+    // set by the signal handlers. all solvers in the process stop or report at the next iteration.
+    static std::atomic<bool> isStopRequested;
+    static std::atomic<bool> isProgressRequested;
     #pragma endregion Field
 }; // Solver 
 
@@ -1,10 +1,28 @@
 #include "Utility.h"
 
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <thread>
+
+#include <cstdint>
+
 #if _OS_MS_WINDOWS
 #include <Windows.h>
 #include <Psapi.h>
+#include <malloc.h>
 #else
 // EXTEND[szx][9]: get memory usage on *nix.
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#if _OS_GNU_LINUX
+#include <sched.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif // _OS_GNU_LINUX
 #endif // _OS_MS_WINDOWS
 
 
@@ -13,6 +31,68 @@ using namespace std;
 
 namespace szx {
 
+void* Memory::allocate(size_t size, size_t alignment, Page page) {
+    if (size == 0) { return nullptr; }
+
+    void *p = nullptr;
+    #if _OS_MS_WINDOWS
+    if (page == Page::ExplicitHugePage) { // requires the SeLockMemoryPrivilege.
+        SIZE_T largePageSize = GetLargePageMinimum();
+        if (largePageSize > 0) {
+            SIZE_T roundedSize = (size + largePageSize - 1) / largePageSize * largePageSize;
+            p = VirtualAlloc(NULL, roundedSize, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+        }
+        if (p == nullptr) { p = VirtualAlloc(NULL, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE); }
+    } else { // EXTEND[szx][5]: there is no transparent huge page on Windows.
+        p = _aligned_malloc(size, alignment);
+    }
+    #else
+    size_t roundedSize = (size + HugePageSize - 1) / HugePageSize * HugePageSize;
+    if (page == Page::ExplicitHugePage) {
+        #ifdef MAP_HUGETLB
+        p = mmap(nullptr, roundedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        #else
+        p = MAP_FAILED;
+        #endif // MAP_HUGETLB
+        if (p == MAP_FAILED) { // no reserved huge pages.
+            p = mmap(nullptr, roundedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            #ifdef MADV_HUGEPAGE
+            if (p != MAP_FAILED) { madvise(p, roundedSize, MADV_HUGEPAGE); }
+            #endif // MADV_HUGEPAGE
+        }
+        if (p == MAP_FAILED) { p = nullptr; }
+    } else {
+        bool isHuge = (page == Page::TransparentHugePage) && (size >= HugePageSize);
+        if (posix_memalign(&p, isHuge ? HugePageSize : alignment, size) != 0) { p = nullptr; }
+        #ifdef MADV_HUGEPAGE
+        if (isHuge && (p != nullptr)) { madvise(p, size / HugePageSize * HugePageSize, MADV_HUGEPAGE); } // the partial tail page may be shared.
+        #endif // MADV_HUGEPAGE
+    }
+    #endif // _OS_MS_WINDOWS
+
+    if (p == nullptr) { throw bad_alloc(); }
+    return p;
+}
+
+void Memory::deallocate(void *p, size_t size, Page page) {
+    if (p == nullptr) { return; }
+
+    #if _OS_MS_WINDOWS
+    if (page == Page::ExplicitHugePage) {
+        VirtualFree(p, 0, MEM_RELEASE);
+    } else {
+        _aligned_free(p);
+    }
+    #else
+    if (page == Page::ExplicitHugePage) {
+        munmap(p, (size + HugePageSize - 1) / HugePageSize * HugePageSize);
+    } else {
+        free(p);
+    }
+    #endif // _OS_MS_WINDOWS
+}
+
+
 System::MemoryUsage System::memoryUsage() {
     MemoryUsage mu = { 0, 0 };
 
@@ -49,4 +129,296 @@ System::MemoryUsage System::peakMemoryUsage() {
     return mu;
 }
 
+
+bool MappedFile::open(const string &path, Mode mode) {
+    close();
+
+    #if _OS_MS_WINDOWS
+    DWORD access = (mode == Mode::ReadOnly) ? GENERIC_READ : (GENERIC_READ | GENERIC_WRITE);
+    fileHandle = CreateFileA(path.c_str(), access, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (fileHandle == INVALID_HANDLE_VALUE) { fileHandle = nullptr; return false; }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize)) { close(); return false; }
+    len = static_cast<size_t>(fileSize.QuadPart);
+    #else
+    fd = ::open(path.c_str(), (mode == Mode::ReadOnly) ? O_RDONLY : O_RDWR);
+    if (fd < 0) { return false; }
+    struct stat st;
+    if (fstat(fd, &st) != 0) { close(); return false; }
+    len = static_cast<size_t>(st.st_size);
+    #endif // _OS_MS_WINDOWS
+
+    return map(mode);
+}
+
+bool MappedFile::create(const string &path, size_t size, bool temporary) {
+    close();
+    len = size;
+
+    #if _OS_MS_WINDOWS
+    DWORD flags = temporary ? (FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE) : FILE_ATTRIBUTE_NORMAL;
+    fileHandle = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_DELETE,
+        NULL, CREATE_ALWAYS, flags, NULL);
+    if (fileHandle == INVALID_HANDLE_VALUE) { fileHandle = nullptr; return false; }
+    LARGE_INTEGER fileSize;
+    fileSize.QuadPart = static_cast<LONGLONG>(size);
+    if (!SetFilePointerEx(fileHandle, fileSize, NULL, FILE_BEGIN) || !SetEndOfFile(fileHandle)) { close(); return false; }
+    #else
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) { return false; }
+    if (temporary) { unlink(path.c_str()); } // the inode lives until the descriptor and mapping are released.
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) { close(); return false; }
+    #endif // _OS_MS_WINDOWS
+
+    return map(Mode::ReadWrite);
+}
+
+void MappedFile::advise(const void *begin, size_t size, Advice advice) {
+    #if _OS_MS_WINDOWS
+    // EXTEND[szx][5]: use PrefetchVirtualMemory() for WillNeed on Windows 8+.
+    #else
+    static const int advices[] = { MADV_NORMAL, MADV_SEQUENTIAL, MADV_RANDOM, MADV_WILLNEED, MADV_DONTNEED };
+    // madvise() requires a page aligned address.
+    uintptr_t pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    uintptr_t addr = reinterpret_cast<uintptr_t>(begin);
+    uintptr_t alignedAddr = addr / pageSize * pageSize;
+    madvise(reinterpret_cast<void*>(alignedAddr), size + (addr - alignedAddr), advices[advice]);
+    #endif // _OS_MS_WINDOWS
+}
+
+bool MappedFile::map(Mode mode) {
+    if (len == 0) { close(); return false; }
+
+    #if _OS_MS_WINDOWS
+    DWORD protect = (mode == Mode::ReadOnly) ? PAGE_READONLY : PAGE_READWRITE;
+    mapHandle = CreateFileMappingA(fileHandle, NULL, protect,
+        static_cast<DWORD>(static_cast<unsigned long long>(len) >> 32), static_cast<DWORD>(len), NULL);
+    if (mapHandle == NULL) { mapHandle = nullptr; close(); return false; }
+    DWORD access = (mode == Mode::ReadOnly) ? FILE_MAP_READ : FILE_MAP_WRITE;
+    addr = static_cast<char*>(MapViewOfFile(mapHandle, access, 0, 0, len));
+    #else
+    int protect = (mode == Mode::ReadOnly) ? PROT_READ : (PROT_READ | PROT_WRITE);
+    void *p = mmap(nullptr, len, protect, MAP_SHARED, fd, 0);
+    addr = (p == MAP_FAILED) ? nullptr : static_cast<char*>(p);
+    #endif // _OS_MS_WINDOWS
+
+    if (addr == nullptr) { close(); return false; }
+    return true;
+}
+
+void MappedFile::close() {
+    #if _OS_MS_WINDOWS
+    if (addr != nullptr) { UnmapViewOfFile(addr); }
+    if (mapHandle != nullptr) { CloseHandle(mapHandle); }
+    if (fileHandle != nullptr) { CloseHandle(fileHandle); }
+    mapHandle = nullptr;
+    fileHandle = nullptr;
+    #else
+    if (addr != nullptr) { munmap(addr, len); }
+    if (fd >= 0) { ::close(fd); }
+    fd = -1;
+    #endif // _OS_MS_WINDOWS
+
+    addr = nullptr;
+    len = 0;
+}
+
+vector<int> System::allowedCpus() {
+    vector<int> cpus;
+    #if _OS_GNU_LINUX
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    if (sched_getaffinity(0, sizeof(cpuSet), &cpuSet) == 0) {
+        for (int c = 0; c < CPU_SETSIZE; ++c) {
+            if (CPU_ISSET(c, &cpuSet)) { cpus.push_back(c); }
+        }
+    }
+    #endif // _OS_GNU_LINUX
+    if (cpus.empty()) { // EXTEND[szx][5]: use GetProcessAffinityMask() on Windows.
+        for (int c = 0, num = static_cast<int>(thread::hardware_concurrency()); c < num; ++c) { cpus.push_back(c); }
+    }
+    return cpus;
+}
+
+int System::availableCpuNum() {
+    int num = static_cast<int>(allowedCpus().size());
+    int quota = cgroupCpuQuota();
+    if ((quota > 0) && (quota < num)) { num = quota; }
+    return (max)(num, 1);
+}
+
+bool System::pinThread(const vector<int> &cpus) {
+    if (cpus.empty()) { return false; }
+    #if _OS_GNU_LINUX
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for (auto c = cpus.begin(); c != cpus.end(); ++c) { CPU_SET(*c, &cpuSet); }
+    return (sched_setaffinity(0, sizeof(cpuSet), &cpuSet) == 0);
+    #else
+    // EXTEND[szx][5]: use SetThreadGroupAffinity() on Windows.
+    return false;
+    #endif // _OS_GNU_LINUX
+}
+
+vector<int> System::threadSiblings(int cpu) {
+    ifstream ifs("/sys/devices/system/cpu/cpu" + to_string(cpu) + "/topology/thread_siblings_list");
+    string list;
+    vector<int> ids(getline(ifs, list) ? parseIdList(list) : vector<int>());
+    return ids.empty() ? vector<int>(1, cpu) : ids;
+}
+
+vector<int> System::parseIdList(const string &list) {
+    vector<int> ids;
+    istringstream iss(list);
+    string range;
+    while (getline(iss, range, ',')) {
+        if (range.empty() || !isdigit(range[0])) { continue; }
+        auto dash = range.find('-');
+        int first = stoi(range.substr(0, dash));
+        int last = (dash == string::npos) ? first : stoi(range.substr(dash + 1));
+        for (int i = first; i <= last; ++i) { ids.push_back(i); }
+    }
+    return ids;
+}
+
+int System::cgroupCpuQuota() {
+    #if _OS_GNU_LINUX
+    auto ceilDiv = [](long long quota, long long period) {
+        return ((quota > 0) && (period > 0)) ? static_cast<int>((quota + period - 1) / period) : 0;
+    };
+
+    // cgroup v2 ("0::/path" in /proc/self/cgroup), falling back to the root of the namespace.
+    string path;
+    ifstream cgroup("/proc/self/cgroup");
+    for (string line; getline(cgroup, line);) {
+        if (line.compare(0, 3, "0::") == 0) { path = line.substr(3); }
+    }
+    for (auto dir : { "/sys/fs/cgroup" + path, string("/sys/fs/cgroup") }) {
+        ifstream ifs(dir + "/cpu.max");
+        string quota;
+        long long period = 0;
+        if (ifs >> quota >> period) { return (quota == "max") ? 0 : ceilDiv(stoll(quota), period); }
+    }
+
+    // cgroup v1.
+    for (auto dir : { "/sys/fs/cgroup/cpu", "/sys/fs/cgroup/cpu,cpuacct" }) {
+        ifstream quotaFile(string(dir) + "/cpu.cfs_quota_us");
+        ifstream periodFile(string(dir) + "/cpu.cfs_period_us");
+        long long quota = 0;
+        long long period = 0;
+        if ((quotaFile >> quota) && (periodFile >> period)) { return ceilDiv(quota, period); }
+    }
+    #endif // _OS_GNU_LINUX
+    return 0;
+}
+
+
+int Numa::nodeNum() {
+    #if _OS_GNU_LINUX
+    ifstream ifs("/sys/devices/system/node/online");
+    string list;
+    if (getline(ifs, list)) {
+        vector<int> nodes(System::parseIdList(list));
+        if (!nodes.empty()) { return *max_element(nodes.begin(), nodes.end()) + 1; }
+    }
+    #endif // _OS_GNU_LINUX
+    return 1;
+}
+
+vector<int> Numa::cpus(int node) {
+    vector<int> ids;
+    #if _OS_GNU_LINUX
+    ifstream ifs("/sys/devices/system/node/node" + to_string(node) + "/cpulist");
+    string list;
+    if (getline(ifs, list)) { ids = System::parseIdList(list); }
+    #endif // _OS_GNU_LINUX
+    return ids;
+}
+
+bool Numa::bind(const void *begin, size_t size, int node) {
+    constexpr int BindMode = 2; // MPOL_BIND in linux/mempolicy.h.
+    if ((node < 0) || (node >= MaskBitNum)) { return false; } // the single word mask can not express it.
+    return setPolicy(begin, size, BindMode, 1ul << node);
+}
+
+bool Numa::interleave(const void *begin, size_t size) {
+    constexpr int InterleaveMode = 3; // MPOL_INTERLEAVE in linux/mempolicy.h.
+    int num = nodeNum();
+    return setPolicy(begin, size, InterleaveMode, (num >= MaskBitNum) ? ~0ul : ((1ul << num) - 1));
+}
+
+int Numa::nodeOfCpu(int cpu) {
+    for (int node = 0, num = nodeNum(); node < num; ++node) {
+        vector<int> ids(cpus(node));
+        if (find(ids.begin(), ids.end(), cpu) != ids.end()) { return node; }
+    }
+    return 0;
+}
+
+bool Numa::setPolicy(const void *begin, size_t size, int mode, unsigned long nodeMask) {
+    #if _OS_GNU_LINUX
+    constexpr unsigned MoveFlag = (1 << 1); // MPOL_MF_MOVE in linux/mempolicy.h.
+    if ((begin == nullptr) || (size == 0) || (nodeNum() <= 1)) { return false; }
+    // mbind() requires a page aligned address.
+    uintptr_t pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    uintptr_t addr = reinterpret_cast<uintptr_t>(begin);
+    uintptr_t alignedAddr = addr / pageSize * pageSize;
+    unsigned long maxNode = sizeof(nodeMask) * 8 + 1;
+    return (syscall(SYS_mbind, alignedAddr, size + (addr - alignedAddr), mode, &nodeMask, maxNode, MoveFlag) == 0);
+    #else
+    return false;
+    #endif // _OS_GNU_LINUX
+}
+
+
+PerfCounter::PerfCounter(Event event) : fd(-1) {
+    #if _OS_GNU_LINUX
+    static const unsigned int types[] = { PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE };
+    static const unsigned long long configs[] = {
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)
+    };
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = types[event];
+    attr.config = configs[event];
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    #else
+    // EXTEND[szx][5]: read the performance monitoring counters on Windows.
+    #endif // _OS_GNU_LINUX
+}
+
+PerfCounter::~PerfCounter() {
+    #if _OS_GNU_LINUX
+    if (fd >= 0) { ::close(fd); }
+    #endif // _OS_GNU_LINUX
+}
+
+void PerfCounter::start() {
+    #if _OS_GNU_LINUX
+    if (fd < 0) { return; }
+    ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    #endif // _OS_GNU_LINUX
+}
+
+void PerfCounter::stop() {
+    #if _OS_GNU_LINUX
+    if (fd >= 0) { ioctl(fd, PERF_EVENT_IOC_DISABLE, 0); }
+    #endif // _OS_GNU_LINUX
+}
+
+long long PerfCounter::count() const {
+    #if _OS_GNU_LINUX
+    long long value;
+    if ((fd >= 0) && (read(fd, &value, sizeof(value)) == sizeof(value))) { return value; }
+    #endif // _OS_GNU_LINUX
+    return Unavailable;
+}
+
 }
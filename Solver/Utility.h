@@ -18,6 +18,7 @@
 #include <random>
 #include <iostream>
 #include <iomanip>
+#include <type_traits>
 
 #include <cstring>
 #include <cstdlib>
@@ -50,7 +51,58 @@ namespace szx {
 #define RESOLVED_CONCAT3(a, b, c, d)  VERBATIM_CONCAT3(a, b, c, d)
 
 
-template<typename T, typename IndexType = int>
+// raw memory with alignment and page size control.
+class Memory {
+public:
+    static constexpr size_t CacheLineSize = 64;
+    static constexpr size_t HugePageSize = 2 * 1024 * 1024;
+
+    enum Page {
+        DefaultPage,
+        TransparentHugePage, // hint the kernel to back the blocks no less than HugePageSize with huge pages.
+        ExplicitHugePage // reserved huge pages (MAP_HUGETLB or MEM_LARGE_PAGES), or transparent ones if unavailable.
+    };
+
+
+    static void* allocate(size_t size, size_t alignment = CacheLineSize, Page page = Page::DefaultPage);
+    // the size and page must be the same as the allocation.
+    static void deallocate(void *p, size_t size, Page page = Page::DefaultPage);
+};
+
+// allocation policies of Arr and Arr2D.
+// plain new[] and delete[].
+struct PlainAlloc {
+    static constexpr bool PadRows = false;
+
+    template<typename T>
+    static T* allocate(size_t len) { return new T[len]; }
+    template<typename T>
+    static void deallocate(T *p, size_t len) { delete[] p; }
+};
+// cache line aligned blocks, optionally with each row of Arr2D padded to multiples of cache line.
+// only the trivial types are allocated by Memory, the others fall back to new[].
+template<bool PadRowsToCacheLine, Memory::Page PageOption>
+struct CacheAlignedAlloc {
+    static constexpr bool PadRows = PadRowsToCacheLine;
+
+    template<typename T>
+    static T* allocate(size_t len) {
+        if (!std::is_trivial<T>::value) { return new T[len]; }
+        return static_cast<T*>(Memory::allocate(sizeof(T) * len, Memory::CacheLineSize, PageOption));
+    }
+    template<typename T>
+    static void deallocate(T *p, size_t len) {
+        if (p == nullptr) { return; }
+        if (!std::is_trivial<T>::value) { delete[] p; return; }
+        Memory::deallocate(p, sizeof(T) * len, PageOption);
+    }
+};
+using AlignedAlloc = CacheAlignedAlloc<false, Memory::Page::TransparentHugePage>;
+using PaddedAlloc = CacheAlignedAlloc<true, Memory::Page::TransparentHugePage>;
+using HugePageAlloc = CacheAlignedAlloc<true, Memory::Page::ExplicitHugePage>;
+
+
+template<typename T, typename IndexType = int, typename AllocPolicy = PlainAlloc>
 class Arr {
 public:
     // it is always valid before copy assignment due to no reallocation.
@@ -61,7 +113,7 @@ public:
 
     explicit Arr() : arr(nullptr), len(0) {}
     explicit Arr(IndexType length) { allocate(length); }
-    explicit Arr(IndexType length, T *data) : arr(data), len(length) {}
+    explicit Arr(IndexType length, T *data) : arr(data), len(length) {} // data must come from AllocPolicy::allocate().
     explicit Arr(IndexType length, const T &defaultValue) : Arr(length) {
         std::fill(arr, arr + length, defaultValue);
     }
@@ -86,7 +138,7 @@ public:
     }
     Arr& operator=(Arr &&a) {
         if (this != &a) {
-            delete[] arr;
+            clear();
             arr = a.arr;
             len = a.len;
             a.arr = nullptr;
@@ -107,7 +159,7 @@ public:
 
     // remove all items.
     void clear() {
-        delete[] arr;
+        AllocPolicy::deallocate(arr, static_cast<size_t>(len));
         arr = nullptr;
     }
 
@@ -136,7 +188,7 @@ protected:
     // must not be called except init.
     void allocate(IndexType length) {
         // TODO[szx][2]: length > (1 << 32)?
-        arr = new T[static_cast<size_t>(length)];
+        arr = AllocPolicy::template allocate<T>(static_cast<size_t>(length));
         len = length;
     }
 
@@ -151,7 +203,7 @@ protected:
     IndexType len;
 };
 
-template<typename T, typename IndexType = int>
+template<typename T, typename IndexType = int, typename AllocPolicy = PlainAlloc>
 class Arr2D {
 public:
     // it is always valid before copy assignment due to no reallocation.
@@ -160,10 +212,11 @@ public:
 
     enum ResetOption { AllBits0 = 0, AllBits1 = -1 };
 
-    explicit Arr2D() : arr(nullptr), len1(0), len2(0), len(0) {}
-    explicit Arr2D(IndexType length1, IndexType length2) { allocate(length1, length2); }
+    explicit Arr2D() : arr(nullptr), len1(0), len2(0), stride(0), len(0), owner(true) {}
+    explicit Arr2D(IndexType length1, IndexType length2) : owner(true) { allocate(length1, length2); }
+    // take the ownership of data, which must come from AllocPolicy::allocate(). see attach() for the other memory.
     explicit Arr2D(IndexType length1, IndexType length2, T *data)
-        : arr(data), len1(length1), len2(length2), len(length1 * length2) {}
+        : arr(data), len1(length1), len2(length2), stride(length2), len(flatSize(length1, length2)), owner(true) {}
     explicit Arr2D(IndexType length1, IndexType length2, const T &defaultValue) : Arr2D(length1, length2) {
         std::fill(arr, arr + len, defaultValue);
     }
@@ -171,16 +224,17 @@ public:
     Arr2D(const Arr2D &a) : Arr2D(a.len1, a.len2) {
         if (this != &a) { copyData(a.arr); }
     }
-    Arr2D(Arr2D &&a) : Arr2D(a.len1, a.len2, a.arr) { a.arr = nullptr; }
+    Arr2D(Arr2D &&a) : Arr2D(a.len1, a.len2, a.arr) { stride = a.stride; len = a.len; owner = a.owner; a.arr = nullptr; }
 
     Arr2D& operator=(const Arr2D &a) {
         if (this != &a) {
-            if (len != a.len) {
+            if ((len != a.len) || !owner) {
                 clear();
                 init(a.len1, a.len2);
             } else {
                 len1 = a.len1;
                 len2 = a.len2;
+                stride = a.stride;
             }
             copyData(a.arr);
         }
@@ -188,11 +242,13 @@ public:
     }
     Arr2D& operator=(Arr2D &&a) {
         if (this != &a) {
-            delete[] arr;
+            clear();
             arr = a.arr;
             len1 = a.len1;
             len2 = a.len2;
+            stride = a.stride;
             len = a.len;
+            owner = a.owner;
             a.arr = nullptr;
         }
         return *this;
@@ -200,6 +256,18 @@ public:
 
     ~Arr2D() { clear(); }
 
+    // use external memory (e.g., a memory mapped file) without taking its ownership.
+    // the memory must outlive this array and it will not be reallocated.
+    void attach(IndexType length1, IndexType length2, T *data) {
+        clear();
+        arr = data;
+        len1 = length1;
+        len2 = length2;
+        stride = length2;
+        len = flatSize(length1, length2);
+        owner = false;
+    }
+
     // allocate memory if it has not been init before.
     bool init(IndexType length1, IndexType length2) {
         if (arr == nullptr) { // avoid re-init and memory leak.
@@ -211,55 +279,69 @@ public:
 
     // remove all items.
     void clear() {
-        delete[] arr;
+        if (owner) { AllocPolicy::deallocate(arr, len); }
         arr = nullptr;
+        owner = true;
     }
 
     // set all data to val. any value other than 0 or -1 is undefined behavior.
     void reset(ResetOption val = ResetOption::AllBits0) { memset(arr, val, sizeof(T) * len); }
 
-    IndexType getFlatIndex(IndexType i1, IndexType i2) const { return (i1 * len2 + i2); }
+    size_t getFlatIndex(IndexType i1, IndexType i2) const { return (rowOffset(i1) + i2); }
 
-    T* operator[](IndexType i1) { return (arr + i1 * len2); }
-    const T* operator[](IndexType i1) const { return (arr + i1 * len2); }
+    T* operator[](IndexType i1) { return (arr + rowOffset(i1)); }
+    const T* operator[](IndexType i1) const { return (arr + rowOffset(i1)); }
 
-    T& at(IndexType i) { return arr[i]; }
-    const T& at(IndexType i) const { return arr[i]; }
-    T& at(IndexType i1, IndexType i2) { return arr[i1 * len2 + i2]; }
-    const T& at(IndexType i1, IndexType i2) const { return arr[i1 * len2 + i2]; }
+    T& at(size_t i) { return arr[i]; }
+    const T& at(size_t i) const { return arr[i]; }
+    T& at(IndexType i1, IndexType i2) { return arr[rowOffset(i1) + i2]; }
+    const T& at(IndexType i1, IndexType i2) const { return arr[rowOffset(i1) + i2]; }
 
     Iterator begin() { return arr; }
-    Iterator begin(IndexType i1) { return arr + (i1 * len2); }
+    Iterator begin(IndexType i1) { return arr + rowOffset(i1); }
     ConstIterator begin() const { return arr; }
-    ConstIterator begin(IndexType i1) const { return arr + (i1 * len2); }
+    ConstIterator begin(IndexType i1) const { return arr + rowOffset(i1); }
 
     Iterator end() { return (arr + len); }
-    Iterator end(IndexType i1) { return arr + (i1 * len2) + len2; }
+    Iterator end(IndexType i1) { return arr + rowOffset(i1) + len2; }
     ConstIterator end() const { return (arr + len); }
-    ConstIterator end(IndexType i1) const { return arr + (i1 * len2) + len2; }
+    ConstIterator end(IndexType i1) const { return arr + rowOffset(i1) + len2; }
 
     T& front() { return at(0); }
     T& front(IndexType i1) { return at(i1, 0); }
     const T& front() const { return at(0); }
     const T& front(IndexType i1) const { return at(i1, 0); }
 
-    T& back() { return at(len - 1); }
-    T& back(IndexType i1) { return at(i1, len - 1); }
-    const T& back() const { return at(len - 1); }
-    const T& back(IndexType i1) const { return at(i1, len - 1); }
+    T& back() { return at(len1 - 1, len2 - 1); }
+    T& back(IndexType i1) { return at(i1, len2 - 1); }
+    const T& back() const { return at(len1 - 1, len2 - 1); }
+    const T& back(IndexType i1) const { return at(i1, len2 - 1); }
 
     IndexType size1() const { return len1; }
     IndexType size2() const { return len2; }
-    IndexType size() const { return len; }
+    // the distance between the beginning of 2 adjacent rows, which may exceed size2() due to padding.
+    IndexType rowStride() const { return stride; }
+    size_t size() const { return len; }
     bool empty() const { return (len == 0); }
 
 protected:
+    // the number of items may exceed the range of IndexType on huge matrices.
+    static size_t flatSize(IndexType length1, IndexType length2) {
+        return static_cast<size_t>(length1) * static_cast<size_t>(length2);
+    }
+    size_t rowOffset(IndexType i1) const { return static_cast<size_t>(i1) * stride; }
+
     // must not be called except init.
     void allocate(IndexType length1, IndexType length2) {
         len1 = length1;
         len2 = length2;
-        len = length1 * length2;
-        arr = new T[static_cast<size_t>(len)];
+        stride = length2;
+        if (AllocPolicy::PadRows && ((Memory::CacheLineSize % sizeof(T)) == 0)) { // round up to cache lines.
+            IndexType itemPerLine = static_cast<IndexType>(Memory::CacheLineSize / sizeof(T));
+            stride = (length2 + itemPerLine - 1) / itemPerLine * itemPerLine;
+        }
+        len = flatSize(length1, stride);
+        arr = AllocPolicy::template allocate<T>(len);
     }
 
     void copyData(T *data) {
@@ -272,7 +354,71 @@ protected:
     T *arr;
     IndexType len1;
     IndexType len2;
-    IndexType len;
+    IndexType stride;
+    size_t len; // including the padding.
+    bool owner; // the memory should be freed by this array.
+};
+
+// the n*n matrices which are scanned all the time, so they are worth the huge pages.
+template<typename T, typename IndexType = int>
+using LargeArr2D = Arr2D<T, IndexType, AlignedAlloc>;
+
+// symmetric square matrix which only stores the lower triangle (including the diagonal) row by row.
+// row i keeps (i, 0), (i, 1), ..., (i, i) consecutively, so the other half of each row is strided.
+template<typename T, typename IndexType = int>
+class SymArr2D {
+public:
+    explicit SymArr2D() : len1(0) {}
+    explicit SymArr2D(IndexType length) { init(length); }
+    explicit SymArr2D(IndexType length, const T &defaultValue) : SymArr2D(length) {
+        std::fill(data.begin(), data.end(), defaultValue);
+    }
+
+    void init(IndexType length) {
+        len1 = length;
+        data.resize(flatSize(length));
+    }
+
+    void clear() {
+        len1 = 0;
+        data.clear();
+        data.shrink_to_fit();
+    }
+
+    // (i, 0), ..., (i, i).
+    T* lowerRow(IndexType i) { return (data.data() + rowOffset(i)); }
+    const T* lowerRow(IndexType i) const { return (data.data() + rowOffset(i)); }
+
+    T& at(IndexType i1, IndexType i2) { return (i1 < i2) ? data[rowOffset(i2) + i1] : data[rowOffset(i1) + i2]; }
+    const T& at(IndexType i1, IndexType i2) const { return (i1 < i2) ? data[rowOffset(i2) + i1] : data[rowOffset(i1) + i2]; }
+
+    // expand the whole row i into dst which has size() items.
+    void copyRow(IndexType i, T *dst) const {
+        const T *lower = lowerRow(i);
+        std::copy(lower, lower + i + 1, dst);
+        size_t offset = rowOffset(i + 1) + i; // (j, i) for j > i.
+        for (IndexType j = i + 1; j < len1; offset += ++j) { dst[j] = data[offset]; }
+    }
+
+    T* begin() { return data.data(); }
+    T* end() { return data.data() + data.size(); }
+    const T* begin() const { return data.data(); }
+    const T* end() const { return data.data() + data.size(); }
+
+    IndexType size() const { return len1; }
+    bool empty() const { return data.empty(); }
+
+    // the number of stored items of a length by length matrix.
+    static size_t flatSize(IndexType length) {
+        return static_cast<size_t>(length) * (static_cast<size_t>(length) + 1) / 2;
+    }
+
+protected:
+    static size_t rowOffset(IndexType i) { return static_cast<size_t>(i) * (static_cast<size_t>(i) + 1) / 2; }
+
+
+    IndexType len1;
+    std::vector<T> data;
 };
 
 
@@ -715,6 +861,124 @@ public:
 
     static MemoryUsage memoryUsage();
     static MemoryUsage peakMemoryUsage();
+
+    // the cpus in the affinity mask of the process.
+    static std::vector<int> allowedCpus();
+    // the number of cpus the process can make use of, limited by the affinity mask and the cgroup cpu quota.
+    static int availableCpuNum();
+    // restrict the calling thread to the cpus.
+    static bool pinThread(const std::vector<int> &cpus);
+    // the hyperthreads sharing the core with the cpu, including itself.
+    static std::vector<int> threadSiblings(int cpu);
+
+    // parse the list format of sysfs, e.g., "0-3,8,10-11".
+    static std::vector<int> parseIdList(const std::string &list);
+
+protected:
+    // ceil(quota / period) of the cgroup (v2 or v1) of the process, or 0 if there is no limit.
+    static int cgroupCpuQuota();
+};
+
+
+// map a whole file into the address space so that its pages can be shared among processes.
+class MappedFile {
+public:
+    enum Mode { ReadOnly, ReadWrite };
+    // expected access pattern of a range of the mapping (madvise() on *nix).
+    enum Advice { Normal, Sequential, Random, WillNeed, DontNeed };
+
+
+    MappedFile() : addr(nullptr), len(0) {}
+    MappedFile(const MappedFile &) = delete;
+    MappedFile& operator=(const MappedFile &) = delete;
+    ~MappedFile() { close(); }
+
+
+    // map an existing file. return false if it does not exist or can not be mapped.
+    bool open(const std::string &path, Mode mode = Mode::ReadOnly);
+    // create or truncate the file to the given size and map it writable.
+    // the content is all zero. a temporary file is deleted once it is unmapped.
+    bool create(const std::string &path, size_t size, bool temporary = false);
+    // flush dirty pages and unmap the file.
+    void close();
+
+    // hint the kernel about the access pattern of [offset, offset + size), or the whole file if size is 0.
+    void advise(Advice advice, size_t offset = 0, size_t size = 0) const {
+        if (addr != nullptr) { advise(addr + offset, (size == 0) ? (len - offset) : size, advice); }
+    }
+    // hint the kernel about the access pattern of any range inside a mapping.
+    static void advise(const void *begin, size_t size, Advice advice);
+
+    char* data() const { return addr; }
+    size_t size() const { return len; }
+    bool isOpen() const { return (addr != nullptr); }
+
+protected:
+    bool map(Mode mode);
+
+
+    char *addr;
+    size_t len;
+
+    #if _OS_MS_WINDOWS
+    void *fileHandle = nullptr;
+    void *mapHandle = nullptr;
+    #else
+    int fd = -1;
+    #endif // _OS_MS_WINDOWS
+};
+
+
+// numa topology and memory placement through the Linux system calls only.
+// on other platforms there is a single node and the placement does nothing.
+class Numa {
+public:
+    static constexpr int MaskBitNum = sizeof(unsigned long) * 8; // the nodes beyond it can not be bound.
+
+
+    static int nodeNum();
+    // the ids of the cpus on the node.
+    static std::vector<int> cpus(int node);
+
+    // move the pages in [begin, begin + size) to the node and allocate the untouched ones there.
+    static bool bind(const void *begin, size_t size, int node);
+    // spread the pages in [begin, begin + size) over all nodes page by page.
+    static bool interleave(const void *begin, size_t size);
+    // restrict the calling thread to the cpus of the node.
+    static bool pinThread(int node) { return System::pinThread(cpus(node)); }
+    // the node of the cpu, or 0 if it is unknown.
+    static int nodeOfCpu(int cpu);
+
+protected:
+    static bool setPolicy(const void *begin, size_t size, int mode, unsigned long nodeMask);
+};
+
+
+// count hardware events of the calling thread (perf_event_open() on Linux).
+class PerfCounter {
+public:
+    enum Event { CacheMiss, DataTlbMiss };
+
+
+    static constexpr long long Unavailable = -1;
+
+
+    PerfCounter(Event event = Event::CacheMiss);
+    PerfCounter(const PerfCounter &) = delete;
+    PerfCounter& operator=(const PerfCounter &) = delete;
+    ~PerfCounter();
+
+
+    // reset the count to 0 and start counting.
+    void start();
+    void stop();
+    // return Unavailable if the platform or the permission does not support the event.
+    long long count() const;
+
+    bool isAvailable() const { return (fd >= 0); }
+
+protected:
+    int fd;
 };
 
 
@@ -750,8 +1014,8 @@ public:
 class Floyd {
 public:
     // find shortest paths between each pair of nodes.
-    template<typename Weight = Length>
-    static void findAllPairsPaths_asymmetric(Arr2D<Weight> &adjMat) {
+    template<typename Weight = Length, typename AllocPolicy = PlainAlloc>
+    static void findAllPairsPaths_asymmetric(Arr2D<Weight, int, AllocPolicy> &adjMat) {
         ID nodeNum = adjMat.size1();
 
         for (ID mid = 0; mid < nodeNum; ++mid) {
@@ -769,8 +1033,8 @@ public:
     // find shortest paths between each pair of nodes on undirected graph, i.e., the adjMat is symmetric (adjMat[i][j] == adjMat[j][i]).
     // https://cs.stackexchange.com/questions/7644/what-is-the-fastest-algorithm-for-finding-all-shortest-paths-in-a-sparse-graph
     // https://stackoverflow.com/questions/2037735/optimise-floyd-warshall-for-symmetric-adjacency-matrix
-    template<typename Weight = Length>
-    static void findAllPairsPaths_symmetric(Arr2D<Weight> &adjMat) {
+    template<typename Weight = Length, typename AllocPolicy = PlainAlloc>
+    static void findAllPairsPaths_symmetric(Arr2D<Weight, int, AllocPolicy> &adjMat) {
         ID nodeNum = adjMat.size1();
 
         for (ID mid = 0; mid < nodeNum; ++mid) {
@@ -785,10 +1049,29 @@ public:
         }
     }
 
+    // find shortest paths between each pair of nodes on undirected graph whose adjMat only stores the lower triangle.
+    template<typename Weight = Length>
+    static void findAllPairsPaths_symmetric(SymArr2D<Weight> &adjMat) {
+        ID nodeNum = adjMat.size();
+
+        std::vector<Weight> midVec(nodeNum); // the row of mid does not change in its own round.
+        for (ID mid = 0; mid < nodeNum; ++mid) {
+            adjMat.copyRow(mid, midVec.data());
+            for (ID src = 0; src < nodeNum; ++src) {
+                Weight srcMid = midVec[src];
+                auto srcVec = adjMat.lowerRow(src);
+                for (ID dst = 0; dst < src; ++dst) {
+                    Weight w = srcMid + midVec[dst];
+                    if (w < srcVec[dst]) { srcVec[dst] = w; }
+                }
+            }
+        }
+    }
+
 private:
     // the primitive floyd (for documentation only).
-    template<typename Weight = Length>
-    static void findAllPairsPaths(Arr2D<Weight> &adjMat) {
+    template<typename Weight = Length, typename AllocPolicy = PlainAlloc>
+    static void findAllPairsPaths(Arr2D<Weight, int, AllocPolicy> &adjMat) {
         ID nodeNum = adjMat.size1();
 
         for (ID mid = 0; mid < nodeNum; ++mid) {
@@ -0,0 +1,133 @@
+#include "VoronoiEngine.h"
+
+
+using namespace std;
+
+
+namespace szx {
+
+void VoronoiEngine::init(const pb::PCenter::UndirectGraph &graph, Arr2D<Length> &nearestDist, Arr2D<Length> &nearestCenter) {
+    nodeNum = graph.nodenum();
+    D = &nearestDist;
+    F = &nearestCenter;
+
+    Map<pair<ID, ID>, Length> edges; // only record the last appearance of each edge.
+    for (auto e = graph.edges().begin(); e != graph.edges().end(); ++e) {
+        if (e->source() == e->target()) { continue; }
+        edges[{ (min)(e->source(), e->target()), (max)(e->source(), e->target()) }] = e->length();
+    }
+
+    adjBegin.assign(nodeNum + 1, 0);
+    for (auto e = edges.begin(); e != edges.end(); ++e) {
+        ++adjBegin[e->first.first + 1];
+        ++adjBegin[e->first.second + 1];
+    }
+    for (ID n = 0; n < nodeNum; ++n) { adjBegin[n + 1] += adjBegin[n]; }
+    adjNode.resize(adjBegin[nodeNum]);
+    adjLen.resize(adjBegin[nodeNum]);
+    List<ID> tail(adjBegin.begin(), adjBegin.end() - 1);
+    for (auto e = edges.begin(); e != edges.end(); ++e) {
+        ID s = e->first.first;
+        ID t = e->first.second;
+        adjNode[tail[s]] = t;
+        adjLen[tail[s]++] = e->second;
+        adjNode[tail[t]] = s;
+        adjLen[tail[t]++] = e->second;
+    }
+
+    dist.resize(nodeNum);
+    stamp.assign(nodeNum, -1);
+    curStamp = 0;
+    affected.assign(nodeNum, false);
+    affectedNodes.clear();
+}
+
+bool VoronoiEngine::relabel(ID v, ID c, Length d) {
+    Arr2D<Length> &dist(*D);
+    Arr2D<Length> &center(*F);
+    if ((center.at(0, v) == c) || (center.at(1, v) == c)) { return false; }
+    if (d < dist.at(0, v)) {
+        dist.at(1, v) = dist.at(0, v);
+        center.at(1, v) = center.at(0, v);
+        dist.at(0, v) = d;
+        center.at(0, v) = c;
+    } else if (d < dist.at(1, v)) {
+        dist.at(1, v) = d;
+        center.at(1, v) = c;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void VoronoiEngine::addCenter(ID c) {
+    // a node which does not accept c blocks the shortest paths from c through it,
+    // since its 2 nearest centers are no farther than c to the nodes behind it.
+    newStamp();
+    std::priority_queue<pair<Length, ID>, List<pair<Length, ID>>, greater<pair<Length, ID>>> q;
+    setDist(c, 0);
+    q.push({ 0, c });
+    while (!q.empty()) {
+        Length d = q.top().first;
+        ID v = q.top().second;
+        q.pop();
+        if (d > dist[v]) { continue; }
+        if (!relabel(v, c, d)) { continue; }
+        for (ID e = adjBegin[v]; e < adjBegin[v + 1]; ++e) {
+            Length nd = d + adjLen[e];
+            ID u = adjNode[e];
+            if ((nd < D->at(1, u)) && ((stamp[u] != curStamp) || (nd < dist[u]))) {
+                setDist(u, nd);
+                q.push({ nd, u });
+            }
+        }
+    }
+}
+
+void VoronoiEngine::removeCenter(ID c) {
+    // drop c from the labels. the remaining labels are still exact.
+    affectedNodes.clear();
+    for (ID v = 0; v < nodeNum; ++v) {
+        if (F->at(0, v) == c) {
+            D->at(0, v) = D->at(1, v);
+            F->at(0, v) = F->at(1, v);
+        } else if (F->at(1, v) != c) {
+            continue;
+        }
+        D->at(1, v) = Problem::MaxDistance;
+        F->at(1, v) = noCenter();
+        affected[v] = true;
+        affectedNodes.push_back(v);
+    }
+
+    // the missing labels come either from the unaffected neighbors at the boundary
+    // of the cells of c or from the affected neighbors labeled earlier.
+    LabelQueue q;
+    for (auto v = affectedNodes.begin(); v != affectedNodes.end(); ++v) {
+        for (ID e = adjBegin[*v]; e < adjBegin[*v + 1]; ++e) {
+            ID u = adjNode[e];
+            for (int k = 0; k < 2; ++k) {
+                ID s = F->at(k, u);
+                if ((s != noCenter()) && (s != F->at(0, *v))) { q.push(Label(D->at(k, u) + adjLen[e], *v, s)); }
+            }
+        }
+    }
+    while (!q.empty()) {
+        Length d = get<0>(q.top());
+        ID v = get<1>(q.top());
+        ID s = get<2>(q.top());
+        q.pop();
+        if (F->at(1, v) != noCenter()) { continue; } // both labels are settled.
+        if (!relabel(v, s, d)) { continue; }
+        for (ID e = adjBegin[v]; e < adjBegin[v + 1]; ++e) {
+            ID u = adjNode[e];
+            if (affected[u] && (F->at(1, u) == noCenter()) && (F->at(0, u) != s)) {
+                q.push(Label(d + adjLen[e], u, s));
+            }
+        }
+    }
+
+    for (auto v = affectedNodes.begin(); v != affectedNodes.end(); ++v) { affected[*v] = false; }
+}
+
+}
@@ -0,0 +1,117 @@
+////////////////////////////////
+/// usage : 1.	maintain the nearest and the second nearest center of each node on sparse graphs
+///             without the all pairs distance matrix.
+///
+/// note  : 1.	the labels are kept in the same 2 x nodeNum arrays as the matrix based solver,
+///             i.e., D[0][v]/F[0][v] is the nearest center and D[1][v]/F[1][v] is the second one.
+///         2.	a center c is among the 2 nearest centers of v implies it is among the 2 nearest
+///             centers of every node on the shortest path from c to v, so only the nodes whose
+///             labels change are visited on each update.
+////////////////////////////////
+
+#ifndef SMART_SZX_P_CENTER_VORONOI_ENGINE_H
+#define SMART_SZX_P_CENTER_VORONOI_ENGINE_H
+
+
+#include "Config.h"
+
+#include <functional>
+#include <queue>
+#include <tuple>
+
+#include "Common.h"
+#include "Utility.h"
+#include "Problem.h"
+
+
+namespace szx {
+
+class VoronoiEngine {
+public:
+    // (distance, node, center).
+    using Label = std::tuple<Length, ID, ID>;
+    using LabelQueue = std::priority_queue<Label, List<Label>, std::greater<Label>>;
+
+
+    VoronoiEngine() : nodeNum(0), D(nullptr), F(nullptr), curStamp(0) {}
+
+
+    // build the compressed sparse row adjacency from the edges and bind the label arrays.
+    // F should be filled with nodeNum (no center) and D with Problem::MaxDistance.
+    void init(const pb::PCenter::UndirectGraph &graph, Arr2D<Length> &nearestDist, Arr2D<Length> &nearestCenter);
+
+    bool isEnabled() const { return (nodeNum > 0); }
+
+    // open center c and update the nodes whose 2 nearest centers change.
+    void addCenter(ID c);
+    // close center c and repair the labels of the nodes in its first or second order cell.
+    void removeCenter(ID c);
+
+    // call visit(node, dist) on each node whose distance to src is no greater than radius.
+    template<typename Visit>
+    void forEachNodeWithin(ID src, Length radius, Visit visit) {
+        newStamp();
+        std::priority_queue<std::pair<Length, ID>, List<std::pair<Length, ID>>, std::greater<std::pair<Length, ID>>> q;
+        setDist(src, 0);
+        q.push({ 0, src });
+        while (!q.empty()) {
+            Length d = q.top().first;
+            ID v = q.top().second;
+            q.pop();
+            if (d > dist[v]) { continue; }
+            visit(v, d);
+            for (ID e = adjBegin[v]; e < adjBegin[v + 1]; ++e) {
+                Length nd = d + adjLen[e];
+                ID u = adjNode[e];
+                if ((nd <= radius) && ((stamp[u] != curStamp) || (nd < dist[u]))) {
+                    setDist(u, nd);
+                    q.push({ nd, u });
+                }
+            }
+        }
+    }
+
+    // the memory footprint in bytes.
+    size_t memoryUsage() const {
+        return sizeof(ID) * (adjBegin.size() + adjNode.size() + stamp.size())
+            + sizeof(Length) * (adjLen.size() + dist.size()) + affected.size() / 8;
+    }
+
+protected:
+    ID noCenter() const { return nodeNum; }
+
+    // accept center c at distance d as a label of v if it is one of the 2 nearest.
+    // return false if the label is not better than the existing ones.
+    bool relabel(ID v, ID c, Length d);
+
+    void newStamp() {
+        if (++curStamp == 0) { std::fill(stamp.begin(), stamp.end(), -1); } // overflow.
+    }
+    void setDist(ID v, Length d) {
+        stamp[v] = curStamp;
+        dist[v] = d;
+    }
+
+
+    ID nodeNum;
+    // the neighbors of node v are adjNode[adjBegin[v]..adjBegin[v + 1]).
+    List<ID> adjBegin;
+    List<ID> adjNode;
+    List<Length> adjLen;
+
+    Arr2D<Length> *D; // D[0][v] and D[1][v] are the distances to the 2 nearest centers.
+    Arr2D<Length> *F; // F[0][v] and F[1][v] are the 2 nearest centers.
+
+    // tentative distance of the current search. dist[v] is valid if stamp[v] == curStamp.
+    List<Length> dist;
+    List<int> stamp;
+    int curStamp;
+
+    List<bool> affected;
+    List<ID> affectedNodes;
+};
+
+}
+
+
+#endif // SMART_SZX_P_CENTER_VORONOI_ENGINE_H